@@ -0,0 +1,130 @@
+// microbenchmarks of natural on Google Benchmark, operand sizes in limbs
+// g++ -std=c++17 -O2 -DNDEBUG bench/natural.cpp -lbenchmark -lpthread -o natural_bench
+// ./natural_bench --benchmark_format=json --benchmark_out=natural.json
+// items_per_second counts limbs, so the tiers of multiply_policy show up as bends across the sizes
+#include "../utility/natural.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <sstream>
+
+namespace {
+    using namespace hwshqtb::big_number;
+
+    // the default 1024-bit std::array storage and growable storage
+    using fixed_natural = natural<>;
+    using dynamic_natural = natural<std::size_t, std::vector<std::size_t>>;
+
+    template <class Natural>
+    Natural operand(std::size_t limbs, std::uint64_t seed) {
+        std::mt19937_64 urbg(seed);
+        return Natural::random(limbs * Natural::type_width, urbg, std::uniform_int_distribution<typename Natural::value_type>());
+    }
+
+    template <class Natural>
+    void bm_add(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(n, 1), y = operand<Natural>(n, 2);
+        for (auto _ : state) benchmark::DoNotOptimize(x + y);
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    template <class Natural>
+    void bm_sub(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(n, 1), y = x >> 1;
+        for (auto _ : state) benchmark::DoNotOptimize(x - y);
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    template <class Natural>
+    void bm_mul(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(n, 1), y = operand<Natural>(n, 2);
+        for (auto _ : state) {
+            // x * y is a product_expression until it is assigned
+            const Natural product = x * y;
+            benchmark::DoNotOptimize(product);
+        }
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    // 2n limbs by n limbs
+    template <class Natural>
+    void bm_div(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(2 * n, 1), y = operand<Natural>(n, 2);
+        for (auto _ : state) benchmark::DoNotOptimize(x / y);
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    template <class Natural>
+    void bm_mod(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(2 * n, 1), y = operand<Natural>(n, 2);
+        for (auto _ : state) benchmark::DoNotOptimize(x % y);
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    // a bit count that is not a multiple of the limb width takes the funnel shift path
+    template <class Natural>
+    void bm_shift_left(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(n, 1);
+        for (auto _ : state) benchmark::DoNotOptimize(x << 13);
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    template <class Natural>
+    void bm_shift_right(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(n, 1);
+        const std::size_t count = n * Natural::type_width / 2 + 13;
+        for (auto _ : state) benchmark::DoNotOptimize(x >> count);
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    // operands that differ in the lowest limb only, every limb is compared
+    template <class Natural>
+    void bm_compare(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(n, 1), y = x + 1;
+        for (auto _ : state) benchmark::DoNotOptimize(x < y);
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    template <class Natural>
+    void bm_write(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        const Natural x = operand<Natural>(n, 1);
+        for (auto _ : state) {
+            std::ostringstream os;
+            os << x;
+            benchmark::DoNotOptimize(os.str().size());
+        }
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+    template <class Natural>
+    void bm_read(benchmark::State& state) {
+        const std::size_t n = (std::size_t)state.range(0);
+        std::ostringstream os;
+        os << operand<Natural>(n, 1);
+        const std::string text = os.str();
+        for (auto _ : state) {
+            std::istringstream is(text);
+            Natural x;
+            is >> x;
+            benchmark::DoNotOptimize(x);
+        }
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+}
+
+// fixed storage up to half its capacity, so that products, dividends and shifted values still fit
+#define HWSHQTB_NATURAL_BENCHMARK(name) \
+    BENCHMARK_TEMPLATE(bm_##name, fixed_natural)->Name(#name "/fixed")->RangeMultiplier(2)->Range(1, 8); \
+    BENCHMARK_TEMPLATE(bm_##name, dynamic_natural)->Name(#name "/dynamic")->RangeMultiplier(4)->Range(1, 100000)
+
+HWSHQTB_NATURAL_BENCHMARK(add);
+HWSHQTB_NATURAL_BENCHMARK(sub);
+HWSHQTB_NATURAL_BENCHMARK(mul);
+HWSHQTB_NATURAL_BENCHMARK(div);
+HWSHQTB_NATURAL_BENCHMARK(mod);
+HWSHQTB_NATURAL_BENCHMARK(shift_left);
+HWSHQTB_NATURAL_BENCHMARK(shift_right);
+HWSHQTB_NATURAL_BENCHMARK(compare);
+HWSHQTB_NATURAL_BENCHMARK(write);
+HWSHQTB_NATURAL_BENCHMARK(read);
+
+BENCHMARK_MAIN();
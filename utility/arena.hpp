@@ -0,0 +1,188 @@
+#ifndef HWSHQTB__BIG_NUMBER__ARENA_HPP
+#define HWSHQTB__BIG_NUMBER__ARENA_HPP
+
+#include "base.hpp"
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+#include <vector>
+
+namespace hwshqtb {
+    namespace big_number {
+        // bump allocator for the intermediate limbs of multiplication, division and radix conversion
+        // memory is handed out in stack order and released back to a mark, released blocks are kept,
+        // so once an arena has seen the largest operation it serves every temporary without the heap
+        // when the arena is released back to empty it keeps one block of at most `retained_block_size`,
+        // so a single huge product does not pin its scratch in a thread for the rest of the program
+        class scratch_arena {
+        public:
+            using size_type = std::size_t;
+
+            // every allocation is aligned for any limb type
+            static constexpr size_type alignment = alignof(std::max_align_t);
+            static constexpr size_type min_block_size = 4096;
+            static constexpr size_type retained_block_size = size_type(1) << 20;
+
+            // a position to release back to
+            struct mark_type {
+                size_type block;
+                size_type offset;
+            };
+
+            scratch_arena() = default;
+            // a block sized by the caller is retained even above `retained_block_size`
+            explicit scratch_arena(size_type bytes):
+                _retained_size(std::max(bytes, retained_block_size)) {
+                add_block(bytes);
+            }
+            scratch_arena(const scratch_arena&) = delete;
+            scratch_arena& operator=(const scratch_arena&) = delete;
+
+            void* allocate(size_type bytes) {
+                bytes = (std::max<size_type>(bytes, 1) + alignment - 1) / alignment * alignment;
+                for (; _block < _blocks.size(); ++_block, _offset = 0)
+                    if (bytes <= _blocks[_block].size - _offset) {
+                        void* p = _blocks[_block].data.get() + _offset;
+                        _offset += bytes;
+                        return p;
+                    }
+                // geometric growth keeps the number of blocks logarithmic in the high-water mark
+                add_block(std::max({bytes, min_block_size, 2 * capacity()}));
+                _offset = bytes;
+                return _blocks[_block].data.get();
+            }
+            mark_type mark()const noexcept {
+                return {_block, _offset};
+            }
+            // gives back everything allocated after `m`
+            void release(mark_type m)noexcept {
+                _block = m.block;
+                _offset = m.offset;
+                if (_block == 0 && _offset == 0) trim();
+            }
+
+            // bytes held by the arena, in use or not
+            size_type capacity()const noexcept {
+                size_type bytes = 0;
+                for (const block_type& block : _blocks) bytes += block.size;
+                return bytes;
+            }
+            // returns the blocks to the heap, nothing may be in use
+            void clear()noexcept {
+                _blocks.clear();
+                _block = _offset = 0;
+            }
+
+            // the arena temporaries of the calling thread come from,
+            // a thread local arena unless a scratch_scope is active
+            static scratch_arena& current()noexcept {
+                return *current_pointer();
+            }
+
+        private:
+            struct block_type {
+                std::unique_ptr<unsigned char[]> data;
+                size_type size;
+            };
+
+            void add_block(size_type bytes) {
+                _blocks.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[bytes]), bytes});
+                _block = _blocks.size() - 1;
+                _offset = 0;
+            }
+
+            // keeps the largest block that is within the retained size, nothing may be in use
+            void trim()noexcept {
+                size_type keep = _blocks.size();
+                for (size_type i = 0; i < _blocks.size(); ++i)
+                    if (_blocks[i].size <= _retained_size && (keep == _blocks.size() || _blocks[i].size > _blocks[keep].size)) keep = i;
+                if (keep == _blocks.size()) {
+                    _blocks.clear();
+                    return;
+                }
+                if (keep != 0) std::swap(_blocks[0], _blocks[keep]);
+                _blocks.erase(_blocks.begin() + 1, _blocks.end());
+            }
+
+            static scratch_arena*& current_pointer()noexcept {
+                static thread_local scratch_arena local;
+                static thread_local scratch_arena* current = &local;
+                return current;
+            }
+
+            friend class scratch_scope;
+
+            std::vector<block_type> _blocks;
+            size_type _block = 0;
+            size_type _offset = 0;
+            size_type _retained_size = retained_block_size;
+
+        };
+
+        // routes the temporaries of the calling thread to `arena` until the scope ends
+        class scratch_scope {
+        public:
+            explicit scratch_scope(scratch_arena& arena)noexcept:
+                _previous(scratch_arena::current_pointer()) {
+                scratch_arena::current_pointer() = &arena;
+            }
+            scratch_scope(const scratch_scope&) = delete;
+            scratch_scope& operator=(const scratch_scope&) = delete;
+            ~scratch_scope() {
+                scratch_arena::current_pointer() = _previous;
+            }
+
+        private:
+            scratch_arena* _previous;
+
+        };
+
+        // `count` uninitialized T from an arena, given back when the buffer goes out of scope
+        // buffers from one arena must die in reverse order of creation, as automatic variables do
+        template <typename T>
+        class scratch_buffer {
+            static_assert(std::is_trivial<T>::value, "T must be trivial type");
+
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+
+            explicit scratch_buffer(size_type count, scratch_arena& arena = scratch_arena::current()):
+                _arena(arena), _mark(arena.mark()), _data(static_cast<T*>(arena.allocate(count * sizeof(T)))), _size(count) {}
+            scratch_buffer(size_type count, T value, scratch_arena& arena = scratch_arena::current()):
+                scratch_buffer(count, arena) {
+                std::fill_n(_data, count, value);
+            }
+            scratch_buffer(const scratch_buffer&) = delete;
+            scratch_buffer& operator=(const scratch_buffer&) = delete;
+            ~scratch_buffer() {
+                _arena.release(_mark);
+            }
+
+            T* data()noexcept {
+                return _data;
+            }
+            const T* data()const noexcept {
+                return _data;
+            }
+            size_type size()const noexcept {
+                return _size;
+            }
+            T& operator[](size_type index)noexcept {
+                return _data[index];
+            }
+            const T& operator[](size_type index)const noexcept {
+                return _data[index];
+            }
+
+        private:
+            scratch_arena& _arena;
+            scratch_arena::mark_type _mark;
+            T* _data;
+            size_type _size;
+
+        };
+    }
+}
+
+#endif
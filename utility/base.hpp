@@ -3,12 +3,501 @@
 
 #include "../version.hpp"
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64))
+#include <intrin.h>
+#define HWSHQTB_BIG_NUMBER_X64_INTRINSICS
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define HWSHQTB_BIG_NUMBER_X64_INTRINSICS
+#endif
+
+// bulk bitwise and compare kernels use the widest vector unit enabled at compile time (-mavx2, /arch:AVX2, ...)
+#if defined(HWSHQTB_BIG_NUMBER_X64_INTRINSICS) && defined(__AVX512F__)
+#define HWSHQTB_BIG_NUMBER_VECTOR_BYTES 64
+#elif defined(HWSHQTB_BIG_NUMBER_X64_INTRINSICS) && defined(__AVX2__)
+#define HWSHQTB_BIG_NUMBER_VECTOR_BYTES 32
+#endif
+
 namespace hwshqtb {
     namespace big_number {
         constexpr const char* NaN_str[2] = {"nan", "NAN"};
         constexpr const char* infinity_str[2] = {"inf", "INF"};
         constexpr const char* hex_str[2] = {"0123456789abcdef", "0123456789ABCDEF"};
+
+        // limb-level kernels shared by every big number type
+        // every kernel works on full-width limbs (base 2^width), least significant limb first
+        namespace kernel {
+            template <typename T>
+            struct limb_traits {
+                static_assert(std::is_integral<T>::value && !std::numeric_limits<T>::is_signed, "limb must be unsigned integral type");
+
+                static constexpr std::size_t width = std::numeric_limits<T>::digits;
+                using wide_type = uint_t<width * 2>;
+            };
+
+            constexpr bool is_constant_evaluated()noexcept {
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+                return __builtin_is_constant_evaluated();
+#else
+                return false;
+#endif
+            }
+
+#if HWSHQTB_BIG_NUMBER_VECTOR_BYTES == 64
+            using vector_type = __m512i;
+
+            inline vector_type vector_load(const void* p)noexcept {
+                return _mm512_loadu_si512(p);
+            }
+            inline void vector_store(void* p, vector_type x)noexcept {
+                _mm512_storeu_si512(p, x);
+            }
+            inline vector_type vector_and(vector_type x, vector_type y)noexcept {
+                return _mm512_and_si512(x, y);
+            }
+            inline vector_type vector_or(vector_type x, vector_type y)noexcept {
+                return _mm512_or_si512(x, y);
+            }
+            inline vector_type vector_xor(vector_type x, vector_type y)noexcept {
+                return _mm512_xor_si512(x, y);
+            }
+            inline vector_type vector_not(vector_type x)noexcept {
+                return _mm512_ternarylogic_epi64(x, x, x, 0x55);
+            }
+            inline bool vector_equal(vector_type x, vector_type y)noexcept {
+                return _mm512_cmpneq_epi64_mask(x, y) == 0;
+            }
+#elif HWSHQTB_BIG_NUMBER_VECTOR_BYTES == 32
+            using vector_type = __m256i;
+
+            inline vector_type vector_load(const void* p)noexcept {
+                return _mm256_loadu_si256((const __m256i*)p);
+            }
+            inline void vector_store(void* p, vector_type x)noexcept {
+                _mm256_storeu_si256((__m256i*)p, x);
+            }
+            inline vector_type vector_and(vector_type x, vector_type y)noexcept {
+                return _mm256_and_si256(x, y);
+            }
+            inline vector_type vector_or(vector_type x, vector_type y)noexcept {
+                return _mm256_or_si256(x, y);
+            }
+            inline vector_type vector_xor(vector_type x, vector_type y)noexcept {
+                return _mm256_xor_si256(x, y);
+            }
+            inline vector_type vector_not(vector_type x)noexcept {
+                return _mm256_xor_si256(x, _mm256_set1_epi64x(-1));
+            }
+            inline bool vector_equal(vector_type x, vector_type y)noexcept {
+                return _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) == -1;
+            }
+#endif
+
+            // returns x + y + carry, carry (0 or 1) becomes the carry-out
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T add_carry(T x, T y, T& carry)noexcept {
+#if defined(HWSHQTB_BIG_NUMBER_X64_INTRINSICS)
+                if (sizeof(T) == 8 && !is_constant_evaluated()) {
+                    unsigned long long result = 0;
+                    carry = _addcarry_u64((unsigned char)carry, x, y, &result);
+                    return (T)result;
+                }
+#endif
+                using wide_type = typename limb_traits<T>::wide_type;
+                wide_type sum = (wide_type)x + y + carry;
+                carry = (T)(sum >> limb_traits<T>::width);
+                return (T)sum;
+            }
+            // returns x - y - borrow, borrow (0 or 1) becomes the borrow-out
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T sub_borrow(T x, T y, T& borrow)noexcept {
+#if defined(HWSHQTB_BIG_NUMBER_X64_INTRINSICS)
+                if (sizeof(T) == 8 && !is_constant_evaluated()) {
+                    unsigned long long result = 0;
+                    borrow = _subborrow_u64((unsigned char)borrow, x, y, &result);
+                    return (T)result;
+                }
+#endif
+                using wide_type = typename limb_traits<T>::wide_type;
+                wide_type difference = (wide_type)x - y - borrow;
+                borrow = (T)(difference >> limb_traits<T>::width) & 1;
+                return (T)difference;
+            }
+            // returns low half of x * y + addend + carry, carry becomes the high half
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T mul_add(T x, T y, T addend, T& carry)noexcept {
+                using wide_type = typename limb_traits<T>::wide_type;
+                wide_type product = (wide_type)x * y + addend + carry;
+                carry = (T)(product >> limb_traits<T>::width);
+                return (T)product;
+            }
+
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 std::size_t count_leading_zeros(T x)noexcept {
+                if (x == 0) return limb_traits<T>::width;
+#if defined(__GNUC__) || defined(__clang__)
+                if (sizeof(T) <= sizeof(unsigned int))
+                    return __builtin_clz(x) - (std::numeric_limits<unsigned int>::digits - limb_traits<T>::width);
+                return __builtin_clzll(x) - (std::numeric_limits<unsigned long long>::digits - limb_traits<T>::width);
+#else
+                std::size_t result = 0;
+                for (T mask = (T)1 << (limb_traits<T>::width - 1); !(x & mask); mask >>= 1)
+                    ++result;
+                return result;
+#endif
+            }
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 std::size_t count_trailing_zeros(T x)noexcept {
+                if (x == 0) return limb_traits<T>::width;
+#if defined(__GNUC__) || defined(__clang__)
+                if (sizeof(T) <= sizeof(unsigned int))
+                    return __builtin_ctz(x);
+                return __builtin_ctzll(x);
+#else
+                std::size_t result = 0;
+                for (; !(x & 1); x >>= 1)
+                    ++result;
+                return result;
+#endif
+            }
+
+            // length without leading zero limbs (at least 1 when n > 0)
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 std::size_t normalized_length(const T* x, std::size_t n)noexcept {
+                while (n > 1 && x[n - 1] == 0) --n;
+                return n;
+            }
+
+            // -1, 0, 1 for x <=> y with both of length n
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 int compare_n(const T* x, const T* y, std::size_t n)noexcept {
+#if defined(HWSHQTB_BIG_NUMBER_VECTOR_BYTES)
+                // skip equal blocks from the top, the scalar loop then finds the first difference
+                constexpr std::size_t step = HWSHQTB_BIG_NUMBER_VECTOR_BYTES / sizeof(T);
+                if (!is_constant_evaluated())
+                    while (n >= step && vector_equal(vector_load(x + n - step), vector_load(y + n - step)))
+                        n -= step;
+#endif
+                while (n > 0) {
+                    --n;
+                    if (x[n] != y[n]) return x[n] < y[n] ? -1 : 1;
+                }
+                return 0;
+            }
+            // -1, 0, 1 for x <=> y, both normalized
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 int compare(const T* x, std::size_t nx, const T* y, std::size_t ny)noexcept {
+                if (nx != ny) return nx < ny ? -1 : 1;
+                return compare_n(x, y, nx);
+            }
+
+            struct bit_and {
+                template <typename T>
+                constexpr T operator()(T x, T y)const noexcept {
+                    return x & y;
+                }
+#if defined(HWSHQTB_BIG_NUMBER_VECTOR_BYTES)
+                vector_type operator()(vector_type x, vector_type y)const noexcept {
+                    return vector_and(x, y);
+                }
+#endif
+            };
+            struct bit_or {
+                template <typename T>
+                constexpr T operator()(T x, T y)const noexcept {
+                    return x | y;
+                }
+#if defined(HWSHQTB_BIG_NUMBER_VECTOR_BYTES)
+                vector_type operator()(vector_type x, vector_type y)const noexcept {
+                    return vector_or(x, y);
+                }
+#endif
+            };
+            struct bit_xor {
+                template <typename T>
+                constexpr T operator()(T x, T y)const noexcept {
+                    return x ^ y;
+                }
+#if defined(HWSHQTB_BIG_NUMBER_VECTOR_BYTES)
+                vector_type operator()(vector_type x, vector_type y)const noexcept {
+                    return vector_xor(x, y);
+                }
+#endif
+            };
+            // r[0, n) = x[0, n) op y[0, n) limb by limb, r may alias x or y
+            template <typename T, class Operation>
+            HWSHQTB_CONSTEXPR14 void bitwise_n(T* r, const T* x, const T* y, std::size_t n, Operation operation)noexcept {
+                std::size_t i = 0;
+#if defined(HWSHQTB_BIG_NUMBER_VECTOR_BYTES)
+                constexpr std::size_t step = HWSHQTB_BIG_NUMBER_VECTOR_BYTES / sizeof(T);
+                if (!is_constant_evaluated())
+                    for (const std::size_t bulk = n - n % step; i < bulk; i += step)
+                        vector_store(r + i, operation(vector_load(x + i), vector_load(y + i)));
+#endif
+                for (; i < n; ++i)
+                    r[i] = (T)operation(x[i], y[i]);
+            }
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void and_n(T* r, const T* x, const T* y, std::size_t n)noexcept {
+                bitwise_n(r, x, y, n, bit_and());
+            }
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void or_n(T* r, const T* x, const T* y, std::size_t n)noexcept {
+                bitwise_n(r, x, y, n, bit_or());
+            }
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void xor_n(T* r, const T* x, const T* y, std::size_t n)noexcept {
+                bitwise_n(r, x, y, n, bit_xor());
+            }
+            // r[0, n) = ~x[0, n), r may alias x
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void not_n(T* r, const T* x, std::size_t n)noexcept {
+                std::size_t i = 0;
+#if defined(HWSHQTB_BIG_NUMBER_VECTOR_BYTES)
+                constexpr std::size_t step = HWSHQTB_BIG_NUMBER_VECTOR_BYTES / sizeof(T);
+                if (!is_constant_evaluated())
+                    for (const std::size_t bulk = n - n % step; i < bulk; i += step)
+                        vector_store(r + i, vector_not(vector_load(x + i)));
+#endif
+                for (; i < n; ++i)
+                    r[i] = (T)~x[i];
+            }
+
+            // r[0, n) = x[0, n) + y[0, n), returns carry-out; r may alias x or y
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T add_n(T* r, const T* x, const T* y, std::size_t n)noexcept {
+                T carry = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = add_carry(x[i], y[i], carry);
+                return carry;
+            }
+            // r[0, n) = x[0, n) + y, returns carry-out; r may alias x
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T add_1(T* r, const T* x, std::size_t n, T y)noexcept {
+                std::size_t i = 0;
+                for (; i < n && y != 0; ++i)
+                    y = (r[i] = x[i] + y) < y;
+                if (r != x)
+                    for (; i < n; ++i)
+                        r[i] = x[i];
+                return y;
+            }
+            // r[0, nx) = x[0, nx) + y[0, ny) with nx >= ny, returns carry-out
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T add(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny)noexcept {
+                return add_1(r + ny, x + ny, nx - ny, add_n(r, x, y, ny));
+            }
+            // r[0, n) = x[0, n) - y[0, n), returns borrow-out; r may alias x or y
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T sub_n(T* r, const T* x, const T* y, std::size_t n)noexcept {
+                T borrow = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = sub_borrow(x[i], y[i], borrow);
+                return borrow;
+            }
+            // r[0, n) = x[0, n) - y, returns borrow-out; r may alias x
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T sub_1(T* r, const T* x, std::size_t n, T y)noexcept {
+                std::size_t i = 0;
+                for (; i < n && y != 0; ++i) {
+                    T v = x[i];
+                    r[i] = v - y;
+                    y = v < y;
+                }
+                if (r != x)
+                    for (; i < n; ++i)
+                        r[i] = x[i];
+                return y;
+            }
+            // r[0, nx) = x[0, nx) - y[0, ny) with nx >= ny, returns borrow-out
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T sub(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny)noexcept {
+                return sub_1(r + ny, x + ny, nx - ny, sub_n(r, x, y, ny));
+            }
+
+            // r[0, n) = x[0, n) * y, returns the high limb; r may alias x
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T mul_1(T* r, const T* x, std::size_t n, T y)noexcept {
+                T carry = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = mul_add(x[i], y, (T)0, carry);
+                return carry;
+            }
+            // r[0, n) += x[0, n) * y, returns the high limb
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T addmul_1(T* r, const T* x, std::size_t n, T y)noexcept {
+                T carry = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = mul_add(x[i], y, r[i], carry);
+                return carry;
+            }
+            // r[0, n) -= x[0, n) * y, returns the limb still to be subtracted above r[n - 1]
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T submul_1(T* r, const T* x, std::size_t n, T y)noexcept {
+                T carry = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    T borrow = 0;
+                    T product = mul_add(x[i], y, (T)0, carry);
+                    r[i] = sub_borrow(r[i], product, borrow);
+                    carry += borrow;
+                }
+                return carry;
+            }
+
+            // r[0, nx + ny - 1) = x[0, nx) * y[0, ny), returns the top limb r[nx + ny - 1]
+            // r must not alias x or y
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T mul_basecase(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny)noexcept {
+                T top = mul_1(r, x, nx, y[0]);
+                for (std::size_t j = 1; j < ny; ++j) {
+                    r[nx + j - 1] = top;
+                    top = addmul_1(r + j, x, nx, y[j]);
+                }
+                return top;
+            }
+
+            // q[0, n) = x[0, n) / y, returns x % y; q may alias x
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T divrem_1(T* q, const T* x, std::size_t n, T y)noexcept {
+                using wide_type = typename limb_traits<T>::wide_type;
+                T remainder = 0;
+                for (std::size_t i = n; i > 0; --i) {
+                    wide_type v = ((wide_type)remainder << limb_traits<T>::width) | x[i - 1];
+                    q[i - 1] = (T)(v / y);
+                    remainder = (T)(v % y);
+                }
+                return remainder;
+            }
+            // x[0, n) % y
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T mod_1(const T* x, std::size_t n, T y)noexcept {
+                using wide_type = typename limb_traits<T>::wide_type;
+                T remainder = 0;
+                for (std::size_t i = n; i > 0; --i)
+                    remainder = (T)((((wide_type)remainder << limb_traits<T>::width) | x[i - 1]) % y);
+                return remainder;
+            }
+            // floor(x^(1 / k)) for k >= 1, Newton's iteration from the power of two above the root
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T root_1(T x, std::size_t k)noexcept {
+                using wide_type = typename limb_traits<T>::wide_type;
+                const std::size_t bits = limb_traits<T>::width - count_leading_zeros(x);
+                if (k == 1 || x == 0) return x;
+                if (bits <= k) return 1;
+                wide_type root = (wide_type)1 << ((bits + k - 1) / k);
+                while (true) {
+                    // x / root^(k - 1) one factor at a time, the quotient never exceeds root
+                    wide_type quotient = x;
+                    for (std::size_t i = 1; i < k && quotient != 0; ++i) quotient /= root;
+                    const wide_type next = ((wide_type)(k - 1) * root + quotient) / k;
+                    if (next >= root) return (T)root;
+                    root = next;
+                }
+            }
+            // r[0, n) = x[0, n) << shift with 0 < shift < width, returns the bits shifted out
+            // r may alias x when r >= x
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T lshift(T* r, const T* x, std::size_t n, std::size_t shift)noexcept {
+                const std::size_t back = limb_traits<T>::width - shift;
+                T out = x[n - 1] >> back;
+                for (std::size_t i = n - 1; i > 0; --i)
+                    r[i] = (x[i] << shift) | (x[i - 1] >> back);
+                r[0] = x[0] << shift;
+                return out;
+            }
+
+            // r[0, n) = x[0, n) >> shift with 0 < shift < width, returns the bits shifted out (in the high bits)
+            // r may alias x when r <= x
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T rshift(T* r, const T* x, std::size_t n, std::size_t shift)noexcept {
+                const std::size_t back = limb_traits<T>::width - shift;
+                T out = x[0] << back;
+                for (std::size_t i = 0; i + 1 < n; ++i)
+                    r[i] = (x[i] >> shift) | (x[i + 1] << back);
+                r[n - 1] = x[n - 1] >> shift;
+                return out;
+            }
+
+            // r[0, 2n) = x[0, n)^2, r must not alias x
+            // each product x[i] x[j] with i < j is formed once and doubled, then the squares x[i]^2 are added
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void sqr_basecase(T* r, const T* x, std::size_t n)noexcept {
+                r[0] = 0;
+                r[n] = mul_1(r + 1, x + 1, n - 1, x[0]);
+                for (std::size_t i = 1; i + 1 < n; ++i)
+                    r[n + i] = addmul_1(r + 2 * i + 1, x + i + 1, n - i - 1, x[i]);
+                r[2 * n - 1] = 0;
+                // the off-diagonal half is below B^2n / 2, doubling it cannot carry out
+                lshift(r, r, 2 * n, 1);
+                T carry = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    T high = 0;
+                    const T low = mul_add(x[i], x[i], (T)0, high);
+                    r[2 * i] = add_carry(r[2 * i], low, carry);
+                    r[2 * i + 1] = add_carry(r[2 * i + 1], high, carry);
+                }
+            }
+
+            // limbs of scratch needed by divrem(q, x, nx, y, ny, scratch)
+            constexpr std::size_t divrem_scratch_size(std::size_t nx, std::size_t ny)noexcept {
+                return nx + ny + 1;
+            }
+            // Knuth's Algorithm D, q[0, nx - ny + 1) = x[0, nx) / y[0, ny) and x[0, ny) = x[0, nx) % y[0, ny)
+            // requires nx >= ny >= 2 and y[ny - 1] != 0, q may be null when only the remainder is wanted
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void divrem(T* q, T* x, std::size_t nx, const T* y, std::size_t ny, T* scratch)noexcept {
+                using wide_type = typename limb_traits<T>::wide_type;
+                constexpr std::size_t width = limb_traits<T>::width;
+                // normalize so that the top bit of the divisor is set
+                const std::size_t shift = count_leading_zeros(y[ny - 1]);
+                T* u = scratch;
+                T* v = scratch + nx + 1;
+                if (shift) {
+                    lshift(v, y, ny, shift);
+                    u[nx] = lshift(u, x, nx, shift);
+                }
+                else {
+                    for (std::size_t i = 0; i < ny; ++i) v[i] = y[i];
+                    for (std::size_t i = 0; i < nx; ++i) u[i] = x[i];
+                    u[nx] = 0;
+                }
+                const T v1 = v[ny - 1], v2 = v[ny - 2];
+                for (std::size_t j = nx - ny + 1; j-- > 0;) {
+                    T* uj = u + j;
+                    // estimate from the top two limbs, then refine with the third, at most two too large afterwards
+                    T estimate, rest;
+                    bool refine = true;
+                    if (uj[ny] >= v1) {
+                        estimate = ~(T)0;
+                        rest = uj[ny - 1] + v1;
+                        refine = rest >= v1;
+                    }
+                    else {
+                        const wide_type top = ((wide_type)uj[ny] << width) | uj[ny - 1];
+                        estimate = (T)(top / v1);
+                        rest = (T)(top % v1);
+                    }
+                    while (refine && (wide_type)estimate * v2 > (((wide_type)rest << width) | uj[ny - 2])) {
+                        --estimate;
+                        rest += v1;
+                        refine = rest >= v1;
+                    }
+                    // multiply and subtract, add back once if the estimate was still one too large
+                    const T borrow = submul_1(uj, v, ny, estimate);
+                    const T high = uj[ny];
+                    uj[ny] = high - borrow;
+                    if (high < borrow) {
+                        --estimate;
+                        uj[ny] += add_n(uj, uj, v, ny);
+                    }
+                    if (q) q[j] = estimate;
+                }
+                if (shift) rshift(x, u, ny, shift);
+                else
+                    for (std::size_t i = 0; i < ny; ++i) x[i] = u[i];
+            }
+        }
     }
 }
 
-#endif
\ No newline at end of file
+#endif
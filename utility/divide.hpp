@@ -0,0 +1,123 @@
+#ifndef HWSHQTB__BIG_NUMBER__DIVIDE_HPP
+#define HWSHQTB__BIG_NUMBER__DIVIDE_HPP
+
+#include "multiply.hpp"
+
+namespace hwshqtb {
+    namespace big_number {
+        namespace kernel {
+            // divisor limbs (and quotient limbs) from which division recurses instead of running Algorithm D
+            constexpr std::size_t divide_threshold = 60;
+
+            // scratch limbs needed by div<Policy>(q, x, nx, y, ny, scratch)
+            constexpr std::size_t div_scratch_size(std::size_t nx, std::size_t ny)noexcept {
+                return 3 * nx + 8 * ny + 16 + mul_scratch_size(ny, ny);
+            }
+
+            template <class Policy, typename T>
+            T divrem_dc_n(T* q, T* u, const T* v, std::size_t n, T* scratch);
+
+            // q[0, k) + qh B^k = floor(u[0, 2k) / v[0, k)), u[0, k) becomes the remainder, returns qh
+            // v normalized, Algorithm D below divide_threshold and recursion above
+            template <class Policy, typename T>
+            T divrem_half(T* q, T* u, const T* v, std::size_t k, T* scratch) {
+                if (k >= divide_threshold) return divrem_dc_n<Policy>(q, u, v, k, scratch);
+                T* quotient = scratch;
+                divrem(quotient, u, 2 * k, v, k, quotient + k + 1);
+                for (std::size_t i = 0; i < k; ++i) q[i] = quotient[i];
+                return quotient[k];
+            }
+            // q[0, n) + qh B^n = floor(u[0, 2n) / v[0, n)) for normalized v, u[0, n) becomes the remainder, returns qh
+            // each half of the quotient is estimated from the top half of v and then corrected
+            // by the product with the bottom half, so the cost is O(M(n) log n)
+            template <class Policy, typename T>
+            T divrem_dc_n(T* q, T* u, const T* v, std::size_t n, T* scratch) {
+                const std::size_t lo = n / 2, hi = n - lo;
+                T* product = scratch;
+                T* next = product + n;
+
+                T qh = divrem_half<Policy>(q + lo, u + 2 * lo, v + lo, hi, scratch);
+                mul<Policy>(product, q + lo, hi, v, lo, next);
+                T borrow = sub_n(u + lo, u + lo, product, n);
+                if (qh) borrow += sub_n(u + n, u + n, v, lo);
+                while (borrow) {
+                    qh -= sub_1(q + lo, q + lo, hi, (T)1);
+                    borrow -= add_n(u + lo, u + lo, v, n);
+                }
+
+                const T ql = divrem_half<Policy>(q, u + hi, v + hi, lo, scratch);
+                mul<Policy>(product, v, hi, q, lo, next);
+                borrow = sub_n(u, u, product, n);
+                if (ql) borrow += sub_n(u + lo, u + lo, v, hi);
+                while (borrow) {
+                    sub_1(q, q, lo, (T)1);
+                    borrow -= add_n(u, u, v, n);
+                }
+                return qh;
+            }
+            // q[0, k) = floor(u[0, n + k) / v[0, n)) for k <= n, normalized v and u[k, n + k) < v
+            // u[0, n) becomes the remainder
+            template <class Policy, typename T>
+            void divrem_block(T* q, T* u, std::size_t k, const T* v, std::size_t n, T* scratch) {
+                if (k == n) {
+                    divrem_dc_n<Policy>(q, u, v, n, scratch);
+                    return;
+                }
+                if (k < divide_threshold) {
+                    T* quotient = scratch;
+                    divrem(quotient, u, n + k, v, n, quotient + k + 1);
+                    for (std::size_t i = 0; i < k; ++i) q[i] = quotient[i];
+                    return;
+                }
+                // estimate from the top k limbs of v, then subtract the product with the remaining n - k limbs
+                T qh = divrem_dc_n<Policy>(q, u + n - k, v + n - k, k, scratch);
+                T* product = scratch;
+                mul<Policy>(product, q, k, v, n - k, product + n);
+                T borrow = sub_n(u, u, product, n);
+                if (qh) borrow += sub_n(u + k, u + k, v, n - k);
+                while (borrow) {
+                    qh -= sub_1(q, q, k, (T)1);
+                    borrow -= add_n(u, u, v, n);
+                }
+            }
+            // q[0, nx - ny + 1) = x[0, nx) / y[0, ny) and x[0, ny) = x[0, nx) % y[0, ny), same contract as divrem
+            // requires nx >= ny >= 2 and y[ny - 1] != 0, q may be null, scratch holds div_scratch_size(nx, ny) limbs
+            // large divisors take the divide and conquer path, blocks of ny quotient limbs at a time
+            template <class Policy, typename T>
+            void div(T* q, T* x, std::size_t nx, const T* y, std::size_t ny, T* scratch) {
+                if (ny < divide_threshold || nx - ny < divide_threshold) {
+                    divrem(q, x, nx, y, ny, scratch);
+                    return;
+                }
+                const std::size_t shift = count_leading_zeros(y[ny - 1]);
+                const std::size_t nq = nx - ny + 1;
+                T* u = scratch;
+                T* v = u + nx + 1;
+                T* quotient = v + ny;
+                T* next = quotient + nq;
+                if (shift) {
+                    lshift(v, y, ny, shift);
+                    u[nx] = lshift(u, x, nx, shift);
+                }
+                else {
+                    for (std::size_t i = 0; i < ny; ++i) v[i] = y[i];
+                    for (std::size_t i = 0; i < nx; ++i) u[i] = x[i];
+                    u[nx] = 0;
+                }
+                // u[nx] < 2^shift <= v[ny - 1], so the quotient of u[0, nx + 1) has nq limbs
+                for (std::size_t remaining = nq; remaining > 0;) {
+                    const std::size_t k = remaining % ny ? remaining % ny : ny;
+                    remaining -= k;
+                    divrem_block<Policy>(quotient + remaining, u + remaining, k, v, ny, next);
+                }
+                if (q)
+                    for (std::size_t i = 0; i < nq; ++i) q[i] = quotient[i];
+                if (shift) rshift(x, u, ny, shift);
+                else
+                    for (std::size_t i = 0; i < ny; ++i) x[i] = u[i];
+            }
+        }
+    }
+}
+
+#endif
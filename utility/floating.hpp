@@ -0,0 +1,609 @@
+#ifndef HWSHQTB__BIG_NUMBER__FLOATING_HPP
+#define HWSHQTB__BIG_NUMBER__FLOATING_HPP
+
+#include "integer.hpp"
+#include <cctype>
+#include <cmath>
+#include <string>
+
+namespace hwshqtb {
+    namespace big_number {
+        // (-1)^sign mantissa 2^exponent with a mantissa of exactly `precision` bits, the top one set
+        // every operation is exact on growable naturals first and rounded once to nearest, ties to even
+        // compound assignments round to the precision of *this, binary operators to the larger precision
+        // zeros and infinities are signed like IEEE 754, there are no subnormals
+        template <class Natural = natural<>>
+        class floating {
+        public:
+            using natural_type = Natural;
+            using integer_type = integer<Natural>;
+            using value_type = typename natural_type::value_type;
+            using size_type = typename natural_type::size_type;
+            using exponent_type = std::ptrdiff_t;
+
+        private:
+            using wide_type = natural<value_type, std::vector<value_type>, typename natural_type::policy_type>;
+
+            static constexpr size_type type_width = kernel::limb_traits<value_type>::width;
+            // bits of fixed storage, 0 when the storage grows
+            static constexpr size_type capacity_bits = static_capacity<typename natural_type::container_type>::value * type_width;
+            // |exponent + precision| stays below this, so sums and differences of two exponents never overflow
+            static constexpr exponent_type exponent_limit = std::numeric_limits<exponent_type>::max() / 4;
+
+        public:
+            static constexpr size_type default_precision = capacity_bits && capacity_bits < 256 ? capacity_bits : 256;
+            static constexpr size_type max_precision = capacity_bits ? capacity_bits : std::numeric_limits<size_type>::max() / 4;
+
+            floating()noexcept:
+                _signed(false), _exponent(0), _precision(default_precision), _mantissa() {}
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            floating(Integer v, size_type precision = default_precision):
+                _signed(false), _exponent(0), _precision(clamp(precision)), _mantissa() {
+                using unsigned_type = std::make_unsigned_t<Integer>;
+                wide_type m;
+                m.assign(v < 0 ? (unsigned_type)(0 - (unsigned_type)v) : (unsigned_type)v);
+                assign_rounded(std::move(m), 0, v < 0, false);
+            }
+            // exact for every double once the precision reaches 53 bits
+            floating(double v, size_type precision = default_precision):
+                _signed(false), _exponent(0), _precision(clamp(precision)), _mantissa() {
+                if (std::isnan(v)) to_NaN();
+                else if (std::isinf(v)) to_infinity(std::signbit(v));
+                else if (v == 0) to_zero(std::signbit(v));
+                else {
+                    int e = 0;
+                    const double fraction = std::frexp(std::fabs(v), &e);
+                    wide_type m;
+                    m.assign((std::uint64_t)std::ldexp(fraction, 53));
+                    assign_rounded(std::move(m), (exponent_type)e - 53, v < 0, false);
+                }
+            }
+            floating(const natural_type& v, size_type precision = default_precision):
+                _signed(false), _exponent(0), _precision(clamp(precision)), _mantissa() {
+                if (v.is_NaN()) to_NaN();
+                else if (v.is_inf()) to_infinity(false);
+                else assign_rounded(convert<wide_type>(v), 0, false, false);
+            }
+            floating(const integer_type& v, size_type precision = default_precision):
+                _signed(false), _exponent(0), _precision(clamp(precision)), _mantissa() {
+                if (v.is_NaN()) to_NaN();
+                else if (v.is_infinity()) to_infinity(v.is_negative());
+                else if (v.is_zero()) to_zero(v.is_negative());
+                else assign_rounded(convert<wide_type>(v.magnitude()), 0, v.is_negative(), false);
+            }
+            floating(const floating&) = default;
+            floating(floating&&) = default;
+            ~floating() = default;
+
+            floating& operator=(const floating&) = default;
+            floating& operator=(floating&&) = default;
+
+            bool is_NaN()const noexcept {
+                return _mantissa.is_NaN();
+            }
+            bool is_zero()const noexcept {
+                return _mantissa.is_zero();
+            }
+            bool is_infinity()const noexcept {
+                return _mantissa.is_inf();
+            }
+            // sign bit, also set for negative zero
+            bool is_negative()const noexcept {
+                return _signed;
+            }
+            size_type precision()const noexcept {
+                return _precision;
+            }
+            // *this = (-1)^sign mantissa() 2^exponent(), mantissa() has precision() bits unless zero or special
+            const natural_type& mantissa()const noexcept {
+                return _mantissa;
+            }
+            exponent_type exponent()const noexcept {
+                return _exponent;
+            }
+
+            // rounds to `precision` bits, clamped to [1, max_precision]
+            floating& set_precision(size_type precision) {
+                const size_type target = clamp(precision);
+                if (target == _precision) return *this;
+                _precision = target;
+                if (is_NaN() || is_infinity() || is_zero()) return *this;
+                return assign_rounded(convert<wide_type>(_mantissa), _exponent, _signed, false);
+            }
+
+            floating& negate()noexcept {
+                if (!is_NaN()) _signed = !_signed;
+                return *this;
+            }
+            // *this 2^count, exact unless the exponent range is left
+            floating& scale(exponent_type count)noexcept {
+                if (is_NaN() || is_infinity() || is_zero()) return *this;
+                if (count > exponent_limit - top()) return to_infinity(_signed);
+                if (count < -exponent_limit - top()) return to_zero(_signed);
+                _exponent += count;
+                return *this;
+            }
+
+            floating& operator+=(const floating& other) {
+                return add(other, other._signed);
+            }
+            floating& operator-=(const floating& other) {
+                return add(other, !other._signed);
+            }
+            // mantissas drop their zero low limbs first, so values converted from short integers stay short
+            // an operand far more precise than *this is cut to the bits that can reach the rounded result,
+            // the full product is only formed when the truncated bounds round apart
+            // x * x goes through the squaring kernels
+            floating& operator*=(const floating& other) {
+                if (is_NaN() || other.is_NaN()) return to_NaN();
+                const bool negative = _signed != other._signed;
+                if ((is_infinity() && other.is_zero()) || (is_zero() && other.is_infinity())) return to_NaN();
+                if (is_infinity() || other.is_infinity()) return to_infinity(negative);
+                if (is_zero() || other.is_zero()) return to_zero(negative);
+                exponent_type ex = _exponent, ey = other._exponent;
+                wide_type x = trimmed(_mantissa, ex);
+                if (this == &other) return assign_rounded(x.square(), 2 * ex, negative, false);
+                wide_type y = trimmed(other._mantissa, ey);
+                const exponent_type e = ex + ey;
+
+                const size_type keep = _precision + type_width;
+                if (y.bit_width() > keep) {
+                    wide_type cut = y;
+                    exponent_type ec = e;
+                    // a dropped tail puts the exact product strictly between x cut and x (cut + 1)
+                    if (truncate(cut, ec, keep)) {
+                        wide_type low = x * cut;
+                        wide_type high = low + x;
+                        high -= 1;
+                        floating lower(0, _precision), upper(0, _precision);
+                        lower.assign_rounded(std::move(low), ec, negative, true);
+                        upper.assign_rounded(std::move(high), ec, negative, true);
+                        if (lower._exponent == upper._exponent && lower._mantissa == upper._mantissa && lower.is_infinity() == upper.is_infinity())
+                            return *this = std::move(lower);
+                    }
+                }
+                return assign_rounded(x *= y, e, negative, false);
+            }
+            // x / 0 is a signed infinity for x != 0, 0 / 0 and inf / inf are NaN
+            floating& operator/=(const floating& other) {
+                if (is_NaN() || other.is_NaN()) return to_NaN();
+                const bool negative = _signed != other._signed;
+                if ((is_infinity() && other.is_infinity()) || (is_zero() && other.is_zero())) return to_NaN();
+                if (is_infinity() || other.is_zero()) return to_infinity(negative);
+                if (is_zero() || other.is_infinity()) return to_zero(negative);
+                exponent_type e = _exponent, ey = other._exponent;
+                wide_type x = trimmed(_mantissa, e);
+                const wide_type y = trimmed(other._mantissa, ey);
+                return assign_quotient(std::move(x), y, e - ey, negative);
+            }
+            // sqrt(-0) = -0, NaN below zero
+            floating& sqrt() {
+                if (is_NaN() || is_zero()) return *this;
+                if (_signed) return to_NaN();
+                if (is_infinity()) return *this;
+                wide_type m = convert<wide_type>(_mantissa);
+                exponent_type e = _exponent;
+                // an even exponent and at least 2 precision + 2 bits give a root of precision + 1 bits
+                size_type shift = _precision + 2;
+                if ((e - (exponent_type)shift) & 1) ++shift;
+                m <<= shift;
+                e -= (exponent_type)shift;
+                wide_type root = m;
+                root.isqrt();
+                const bool inexact = root * root != m;
+                return assign_rounded(std::move(root), e / 2, false, inexact);
+            }
+
+            friend floating operator+(const floating& x, const floating& y) {
+                floating result = x;
+                result.widen(y);
+                return result += y;
+            }
+            friend floating operator-(const floating& x, const floating& y) {
+                floating result = x;
+                result.widen(y);
+                return result -= y;
+            }
+            friend floating operator*(const floating& x, const floating& y) {
+                if (&x == &y) {
+                    floating result = x;
+                    return result *= result;
+                }
+                floating result = x;
+                result.widen(y);
+                return result *= y;
+            }
+            friend floating operator/(const floating& x, const floating& y) {
+                floating result = x;
+                result.widen(y);
+                return result /= y;
+            }
+            friend floating operator+(const floating& x) {
+                return x;
+            }
+            friend floating operator-(const floating& x) {
+                floating result = x;
+                return result.negate();
+            }
+
+            // NaN is unordered, +0 == -0
+            friend bool operator==(const floating& x, const floating& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) == 0;
+            }
+            friend bool operator!=(const floating& x, const floating& y)noexcept {
+                return !(x == y);
+            }
+            friend bool operator<(const floating& x, const floating& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) < 0;
+            }
+            friend bool operator<=(const floating& x, const floating& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) <= 0;
+            }
+            friend bool operator>(const floating& x, const floating& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) > 0;
+            }
+            friend bool operator>=(const floating& x, const floating& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) >= 0;
+            }
+
+            // rounded to nearest double, results in the subnormal range may be rounded twice
+            explicit operator double()const {
+                if (is_NaN()) return std::numeric_limits<double>::quiet_NaN();
+                if (is_infinity()) return _signed ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+                if (is_zero()) return _signed ? -0.0 : 0.0;
+                floating rounded(*this);
+                rounded.set_precision(53);
+                double m = 0;
+                for (size_type i = (53 + type_width - 1) / type_width; i-- > 0;)
+                    m = std::ldexp(m, (int)type_width) + (double)rounded._mantissa[i];
+                // ldexp saturates far outside the range of double
+                const exponent_type limit = 1 << 20;
+                const double result = std::ldexp(m, (int)std::max(std::min(rounded._exponent, limit), -limit));
+                return _signed ? -result : result;
+            }
+
+            // significant decimal digits that read back to the same value
+            size_type round_trip_digits()const noexcept {
+                return (size_type)(_precision * 0.30102999566398120) + 2;
+            }
+            // scientific notation d.ddde+xx with `digits` significant digits, rounded to nearest with ties to even
+            // the cost grows with the magnitude of the exponent
+            friend std::to_chars_result to_chars(char* first, char* last, const floating& x, size_type digits) {
+                if (x._signed && !x.is_NaN()) {
+                    if (first == last) return {last, std::errc::value_too_large};
+                    *first++ = '-';
+                }
+                if (x.is_NaN() || x.is_infinity()) {
+                    const char* str = x.is_NaN() ? NaN_str[0] : infinity_str[0];
+                    if (last - first < 3) return {last, std::errc::value_too_large};
+                    for (std::size_t i = 0; i < 3; ++i) *first++ = str[i];
+                    return {first, std::errc()};
+                }
+                digits = std::max<size_type>(digits, 1);
+                std::string text(digits, '0');
+                exponent_type scientific = 0;
+                if (!x.is_zero()) {
+                    // estimate the decimal position of the last digit, correct it once the digits are known
+                    exponent_type k = (exponent_type)std::floor((double)(x._exponent + (exponent_type)x._precision - 1) * 0.30102999566398120) - (exponent_type)digits + 1;
+                    const wide_type low = std::pow(wide_type(10), digits - 1), high = low * wide_type(10);
+                    wide_type n;
+                    for (;;) {
+                        n = x.decimal(k);
+                        if (n >= high) ++k;
+                        else if (n < low) --k;
+                        else break;
+                    }
+                    char* end = text.data() + text.size();
+                    std::to_chars_result result = to_chars(text.data(), end, n);
+                    if (result.ec != std::errc()) return {last, result.ec};
+                    scientific = k + (exponent_type)digits - 1;
+                }
+                char exponent[32];
+                const std::to_chars_result tail = std::to_chars(exponent, exponent + sizeof(exponent), scientific < 0 ? -scientific : scientific);
+                const std::size_t exponent_digits = (std::size_t)(tail.ptr - exponent);
+                const std::size_t length = digits + (digits > 1) + 2 + std::max<std::size_t>(exponent_digits, 2);
+                if ((std::size_t)(last - first) < length) return {last, std::errc::value_too_large};
+                *first++ = text[0];
+                if (digits > 1) {
+                    *first++ = '.';
+                    for (size_type i = 1; i < digits; ++i) *first++ = text[i];
+                }
+                *first++ = 'e';
+                *first++ = scientific < 0 ? '-' : '+';
+                if (exponent_digits < 2) *first++ = '0';
+                for (std::size_t i = 0; i < exponent_digits; ++i) *first++ = exponent[i];
+                return {first, std::errc()};
+            }
+            friend std::to_chars_result to_chars(char* first, char* last, const floating& x) {
+                return to_chars(first, last, x, x.round_trip_digits());
+            }
+            // [-]digits[.digits][e[+-]digits] or [-]nan / [-]inf in any case, rounded to the precision of x
+            // x is left untouched unless the text is valid, the cost grows with the decimal exponent
+            friend std::from_chars_result from_chars(const char* first, const char* last, floating& x) {
+                const char* iter = first;
+                const bool negative = iter != last && *iter == '-';
+                iter += negative;
+                for (std::size_t k = 0; k < 2; ++k) {
+                    const char* str = k == 0 ? NaN_str[0] : infinity_str[0];
+                    std::size_t i = 0;
+                    while (i < 3 && iter + i != last && (iter[i] == str[i] || iter[i] == str[i] - 'a' + 'A')) ++i;
+                    if (i == 3) {
+                        if (k == 0) x.to_NaN();
+                        else x.to_infinity(negative);
+                        return {iter + 3, std::errc()};
+                    }
+                }
+                std::string digits;
+                exponent_type k = 0;
+                bool point = false;
+                for (; iter != last; ++iter) {
+                    if (*iter == '.' && !point) point = true;
+                    else if (*iter >= '0' && *iter <= '9') {
+                        digits.push_back(*iter);
+                        k -= point;
+                    }
+                    else break;
+                }
+                if (digits.empty()) return {first, std::errc::invalid_argument};
+                if (iter != last && (*iter == 'e' || *iter == 'E')) {
+                    const char* start = iter + 1;
+                    start += start != last && *start == '+';
+                    long long scientific = 0;
+                    const std::from_chars_result result = std::from_chars(start, last, scientific);
+                    if (result.ec == std::errc::result_out_of_range) return {first, result.ec};
+                    if (result.ec == std::errc()) {
+                        if (scientific > exponent_limit / 4 || scientific < -exponent_limit / 4) return {first, std::errc::result_out_of_range};
+                        k += (exponent_type)scientific;
+                        iter = result.ptr;
+                    }
+                }
+                wide_type n;
+                from_chars(digits.data(), digits.data() + digits.size(), n);
+                floating value(0, x._precision);
+                if (n.is_zero()) value.to_zero(negative);
+                else if (k >= 0) value.assign_rounded(n * std::pow(wide_type(10), k), 0, negative, false);
+                else value.assign_quotient(std::move(n), std::pow(wide_type(10), -k), 0, negative);
+                x = std::move(value);
+                return {iter, std::errc()};
+            }
+            template <class CharT, class Traits>
+            friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const floating& x) {
+                std::string text(x.round_trip_digits() + 48, '\0');
+                const std::to_chars_result result = to_chars(text.data(), text.data() + text.size(), x);
+                text.resize((std::size_t)(result.ptr - text.data()));
+                if (os.flags() & std::ios_base::uppercase)
+                    for (char& c : text) c = (char)std::toupper((unsigned char)c);
+                if ((os.flags() & std::ios_base::showpos) && !x._signed && !x.is_NaN()) text.insert(text.begin(), '+');
+                for (char c : text) os << os.widen(c);
+                return os;
+            }
+            template <class CharT, class Traits>
+            friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, floating& x) {
+                typename std::basic_istream<CharT, Traits>::sentry check_sentry(is);
+                if (!check_sentry) return is;
+                std::string text;
+                for (typename Traits::int_type c = is.peek(); !Traits::eq_int_type(c, Traits::eof()); c = is.peek()) {
+                    const char narrow = is.narrow(Traits::to_char_type(c), '\0');
+                    const bool sign = (narrow == '-' || narrow == '+') && (text.empty() || text.back() == 'e' || text.back() == 'E');
+                    if (!sign && !std::isalnum((unsigned char)narrow) && narrow != '.') break;
+                    text.push_back(narrow);
+                    is.get();
+                }
+                const char* first = text.data() + (!text.empty() && text[0] == '+');
+                const std::from_chars_result result = from_chars(first, text.data() + text.size(), x);
+                if (result.ec != std::errc() || result.ptr != text.data() + text.size()) is.setstate(std::ios_base::failbit);
+                return is;
+            }
+
+        private:
+            static constexpr size_type clamp(size_type precision)noexcept {
+                return precision < 1 ? 1 : precision > max_precision ? max_precision : precision;
+            }
+            template <class To, class From>
+            static To convert(const From& x) {
+                if constexpr (std::is_same_v<To, From>) return x;
+                else {
+                    std::vector<value_type> limbs(std::max<std::size_t>(1, (x.bit_width() + type_width - 1) / type_width));
+                    for (std::size_t i = 0; i < limbs.size(); ++i) limbs[i] = x[i];
+                    To result;
+                    result.assign_limbs(limbs.data(), limbs.size());
+                    return result;
+                }
+            }
+            // m without its zero low limbs, e grows by the bits dropped
+            static wide_type trimmed(const natural_type& m, exponent_type& e) {
+                const std::size_t n = std::max<std::size_t>(1, (m.bit_width() + type_width - 1) / type_width);
+                std::size_t low = 0;
+                while (low + 1 < n && m[low] == 0) ++low;
+                std::vector<value_type> limbs(n - low);
+                for (std::size_t i = 0; i < limbs.size(); ++i) limbs[i] = m[low + i];
+                wide_type result;
+                result.assign_limbs(limbs.data(), limbs.size());
+                e += (exponent_type)(low * type_width);
+                return result;
+            }
+            // whether any of the bits [0, count) of m is set
+            static bool any_bits(const wide_type& m, size_type count)noexcept {
+                for (size_type i = 0; i < count / type_width; ++i)
+                    if (m[i]) return true;
+                return count % type_width && (m[count / type_width] & (((value_type)1 << (count % type_width)) - 1));
+            }
+            // keeps the top `keep` bits of m, returns whether a set bit was dropped
+            static bool truncate(wide_type& m, exponent_type& e, size_type keep) {
+                const size_type bits = m.bit_width();
+                if (bits <= keep) return false;
+                const bool cut = any_bits(m, bits - keep);
+                m >>= bits - keep;
+                e += (exponent_type)(bits - keep);
+                return cut;
+            }
+
+            floating& to_NaN()noexcept {
+                _signed = false;
+                _exponent = 0;
+                _mantissa.to_NaN();
+                return *this;
+            }
+            floating& to_zero(bool negative)noexcept {
+                _signed = negative;
+                _exponent = 0;
+                _mantissa.to_zero();
+                return *this;
+            }
+            floating& to_infinity(bool negative)noexcept {
+                _signed = negative;
+                _exponent = 0;
+                _mantissa.to_inf();
+                return *this;
+            }
+            // exponent of the bit above the top mantissa bit
+            exponent_type top()const noexcept {
+                return _exponent + (exponent_type)_precision;
+            }
+            // takes the larger precision before a binary operator
+            void widen(const floating& other) {
+                if (other._precision > _precision) set_precision(other._precision);
+            }
+
+            // *this = (-1)^negative (m + sticky / 2) 2^e rounded to precision bits, sticky marks a nonzero tail below m
+            // a sticky tail requires m to carry more than precision bits
+            floating& assign_rounded(wide_type m, exponent_type e, bool negative, bool sticky) {
+                const size_type bits = m.bit_width();
+                if (bits == 0) return to_zero(negative);
+                if (bits > _precision) {
+                    const size_type shift = bits - _precision;
+                    const bool half = (m[(shift - 1) / type_width] >> ((shift - 1) % type_width)) & 1;
+                    sticky = sticky || any_bits(m, shift - 1);
+                    m >>= shift;
+                    e += (exponent_type)shift;
+                    if (half && (sticky || (m[0] & 1))) {
+                        m += 1;
+                        if (m.bit_width() > _precision) {
+                            m >>= 1;
+                            ++e;
+                        }
+                    }
+                }
+                else if (bits < _precision) {
+                    m <<= _precision - bits;
+                    e -= (exponent_type)(_precision - bits);
+                }
+                if (e > exponent_limit - (exponent_type)_precision) return to_infinity(negative);
+                if (e < -exponent_limit - (exponent_type)_precision) return to_zero(negative);
+                _signed = negative;
+                _exponent = e;
+                _mantissa = convert<natural_type>(m);
+                return *this;
+            }
+            // *this = (-1)^negative x / y 2^e rounded, the quotient is taken to precision + 2 bits and the remainder is sticky
+            floating& assign_quotient(wide_type x, const wide_type& y, exponent_type e, bool negative) {
+                const exponent_type bx = (exponent_type)x.bit_width(), by = (exponent_type)y.bit_width();
+                const exponent_type shift = std::max<exponent_type>(0, (exponent_type)_precision + 2 + by - bx);
+                x <<= (size_type)shift;
+                wide_type quotient = x.div(y);
+                return assign_rounded(std::move(quotient), e - shift, negative, !x.is_zero());
+            }
+            // round(|*this| / 10^k) to nearest with ties to even
+            wide_type decimal(exponent_type k)const {
+                wide_type numerator = convert<wide_type>(_mantissa), denominator(1);
+                if (_exponent >= 0) numerator <<= (size_type)_exponent;
+                else denominator <<= (size_type)-_exponent;
+                if (k >= 0) denominator *= std::pow(wide_type(10), k);
+                else numerator *= std::pow(wide_type(10), -k);
+                wide_type quotient = numerator.div(denominator);
+                numerator <<= 1;
+                if (numerator > denominator || (numerator == denominator && (quotient[0] & 1))) quotient += 1;
+                return quotient;
+            }
+
+            // -1, 0, 1 for *this <=> other, neither NaN
+            int compare(const floating& other)const noexcept {
+                if (is_zero() && other.is_zero()) return 0;
+                const int sign = _signed ? -1 : 1;
+                if (_signed != other._signed) return sign;
+                return sign * compare_magnitude(other);
+            }
+            // -1, 0, 1 for |*this| <=> |other|
+            int compare_magnitude(const floating& other)const noexcept {
+                if (is_infinity() || other.is_infinity()) return (int)is_infinity() - (int)other.is_infinity();
+                if (is_zero() || other.is_zero()) return (int)!is_zero() - (int)!other.is_zero();
+                if (top() != other.top()) return top() < other.top() ? -1 : 1;
+                // equal tops, the mantissa of the larger exponent gets the missing low bits
+                if (_precision == other._precision) return _mantissa == other._mantissa ? 0 : _mantissa < other._mantissa ? -1 : 1;
+                wide_type x = convert<wide_type>(_mantissa), y = convert<wide_type>(other._mantissa);
+                if (_precision < other._precision) x <<= other._precision - _precision;
+                else y <<= _precision - other._precision;
+                return x == y ? 0 : x < y ? -1 : 1;
+            }
+            // *this += (-1)^negative |other|
+            floating& add(const floating& other, bool negative) {
+                if (is_NaN() || other.is_NaN()) return to_NaN();
+                if (is_infinity() || other.is_infinity()) {
+                    if (is_infinity() && other.is_infinity() && _signed != negative) return to_NaN();
+                    return is_infinity() ? *this : to_infinity(negative);
+                }
+                if (other.is_zero()) {
+                    // -0 + -0 = -0, any other sum of zeros is +0
+                    if (is_zero()) _signed = _signed && negative;
+                    return *this;
+                }
+                if (is_zero()) return assign_rounded(convert<wide_type>(other._mantissa), other._exponent, negative, false);
+
+                const bool this_top = top() >= other.top();
+                const natural_type& ma = this_top ? _mantissa : other._mantissa;
+                const natural_type& mb = this_top ? other._mantissa : _mantissa;
+                const exponent_type ea = this_top ? _exponent : other._exponent, eb = this_top ? other._exponent : _exponent;
+                const exponent_type ta = this_top ? top() : other.top(), tb = this_top ? other.top() : top();
+                const bool sa = this_top ? _signed : negative, sb = this_top ? negative : _signed;
+                // a and the rounding breakpoints are multiples of 2^g, so any b below 2^g rounds like 2^(g - 1)
+                const exponent_type g = std::min(ea, ta - (exponent_type)_precision - 2);
+                if (tb <= g) {
+                    wide_type m = convert<wide_type>(ma);
+                    m <<= (size_type)(ea - g + 1);
+                    if (sa == sb) m += 1;
+                    else m -= 1;
+                    return assign_rounded(std::move(m), g - 1, sa, false);
+                }
+                const exponent_type e = std::min(ea, eb);
+                wide_type a = convert<wide_type>(ma), b = convert<wide_type>(mb);
+                a <<= (size_type)(ea - e);
+                b <<= (size_type)(eb - e);
+                if (sa == sb) return assign_rounded(a += b, e, sa, false);
+                if (a == b) return to_zero(false);
+                if (a > b) return assign_rounded(a -= b, e, sa, false);
+                return assign_rounded(b -= a, e, sb, false);
+            }
+
+            bool _signed;
+            exponent_type _exponent;
+            size_type _precision;
+            natural_type _mantissa;
+
+        };
+    }
+}
+
+namespace std {
+    template <class Natural>
+    hwshqtb::big_number::floating<Natural> abs(const hwshqtb::big_number::floating<Natural>& x) {
+        hwshqtb::big_number::floating<Natural> result = x;
+        return x.is_negative() ? result.negate() : result;
+    }
+    template <class Natural>
+    hwshqtb::big_number::floating<Natural> sqrt(const hwshqtb::big_number::floating<Natural>& x) {
+        hwshqtb::big_number::floating<Natural> result = x;
+        return result.sqrt();
+    }
+    template <class Natural>
+    hwshqtb::big_number::floating<Natural> ldexp(const hwshqtb::big_number::floating<Natural>& x, std::ptrdiff_t exponent) {
+        hwshqtb::big_number::floating<Natural> result = x;
+        return result.scale(exponent);
+    }
+}
+
+#endif
@@ -0,0 +1,302 @@
+#ifndef HWSHQTB__BIG_NUMBER__GCD_HPP
+#define HWSHQTB__BIG_NUMBER__GCD_HPP
+
+#include "integer.hpp"
+#include <utility>
+#include <vector>
+
+namespace hwshqtb {
+    namespace big_number {
+        namespace kernel {
+            // binary gcd of two limbs
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T gcd_1(T x, T y)noexcept {
+                if (x == 0) return y;
+                if (y == 0) return x;
+                const std::size_t shift = count_trailing_zeros((T)(x | y));
+                x = (T)(x >> count_trailing_zeros(x));
+                do {
+                    y = (T)(y >> count_trailing_zeros(y));
+                    if (x > y) std::swap(x, y);
+                    y = (T)(y - x);
+                }
+                while (y != 0);
+                return (T)(x << shift);
+            }
+
+            // cofactors of `steps` Euclidean steps on a >= b, in magnitude
+            // r_steps = s0 a - t0 b and r_steps+1 = t1 b - s1 a for even steps, the signs flip for odd steps
+            template <typename T>
+            struct lehmer_matrix {
+                T s0, t0, s1, t1;
+                std::size_t steps;
+            };
+            // x / y for double limbs, most quotients of the Euclidean algorithm are tiny
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 typename limb_traits<T>::wide_type quotient_2(typename limb_traits<T>::wide_type x, typename limb_traits<T>::wide_type y)noexcept {
+                if (x < y) return 0;
+                if (x - y < y) return 1;
+                if ((x >> limb_traits<T>::width) == 0) return (T)x / (T)y;
+                return x / y;
+            }
+            // Euclidean steps shared by every a / 2^h in [x, x + 1) and b / 2^h in [y, y + 1), x < 2^(2 width - 1)
+            // each quotient is taken at both corners of the box and kept only when they agree (Knuth's Algorithm L
+            // on double limbs), `exact` means x and y are a and b themselves, stops before a cofactor outgrows a limb
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 lehmer_matrix<T> lehmer(typename limb_traits<T>::wide_type x, typename limb_traits<T>::wide_type y, bool exact)noexcept {
+                using wide_type = typename limb_traits<T>::wide_type;
+                constexpr wide_type limit = (T)~(T)0;
+                wide_type s0 = 1, t0 = 0, s1 = 0, t1 = 1;
+                std::size_t steps = 0;
+                while (y != 0) {
+                    wide_type q = quotient_2<T>(x, y);
+                    if (!exact) {
+                        // the remainders lie in (x - t0, x + s0) and (y - s1, y + t1) for even steps, mirrored for odd
+                        const wide_type low0 = steps % 2 ? s0 : t0, high0 = steps % 2 ? t0 : s0;
+                        const wide_type low1 = steps % 2 ? t1 : s1, high1 = steps % 2 ? s1 : t1;
+                        if (x < low0 || y <= low1) break;
+                        q = quotient_2<T>(x + high0, y - low1);
+                        if (q != quotient_2<T>(x - low0, y + high1)) break;
+                    }
+                    // s0 + q s1 <= a / r, so the products stay below 2^(2 width - 1) + 1
+                    const wide_type s2 = s0 + q * s1, t2 = t0 + q * t1;
+                    if (s2 > limit || t2 > limit) break;
+                    const wide_type r = x - q * y;
+                    x = y;
+                    y = r;
+                    s0 = s1;
+                    t0 = t1;
+                    s1 = s2;
+                    t1 = t2;
+                    ++steps;
+                }
+                return {(T)s0, (T)t0, (T)s1, (T)t1, steps};
+            }
+            // 2 width bits of x[0, n) starting at bit `position`
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 typename limb_traits<T>::wide_type leading_bits(const T* x, std::size_t n, std::size_t position)noexcept {
+                using wide_type = typename limb_traits<T>::wide_type;
+                constexpr std::size_t width = limb_traits<T>::width;
+                const std::size_t index = position / width, offset = position % width;
+                const T low = index < n ? x[index] : 0, high = index + 1 < n ? x[index + 1] : 0;
+                wide_type v = ((wide_type)high << width) | low;
+                if (offset && index + 2 < n)
+                    v = (v >> offset) | ((wide_type)x[index + 2] << (2 * width - offset));
+                else v >>= offset;
+                return v;
+            }
+            // r[0, n) = x[0, n) m - y[0, n) l, the difference must lie in [0, B^n)
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void mul_sub_1(T* r, const T* x, T m, const T* y, T l, std::size_t n)noexcept {
+                mul_1(r, x, n, m);
+                submul_1(r, y, n, l);
+            }
+        }
+
+        // gcd and Bézout coefficients, gcd = x a + y b
+        template <class Natural>
+        struct gcdext_t {
+            Natural gcd;
+            integer<Natural> x, y;
+        };
+
+        // Euclid's algorithm on limb arrays, blocks of about one limb of quotients at a time are folded into a
+        // single cofactor matrix from the top two limbs (Lehmer) and applied in one pass over the numbers
+        // division steps take over when the lengths differ or the leading limbs decide nothing
+        template <class Natural>
+        class euclid {
+        public:
+            using natural_type = Natural;
+            using value_type = typename natural_type::value_type;
+            using size_type = std::size_t;
+            using policy_type = typename natural_type::policy_type;
+
+        private:
+            static constexpr std::size_t type_width = kernel::limb_traits<value_type>::width;
+
+        public:
+            // a and b must be finite, `cofactors` (0 to 2) is how many of the coefficients of a and b in the
+            // remainders are tracked
+            euclid(const natural_type& a, const natural_type& b, size_type cofactors):
+                _n(std::max(length(a), length(b))), _buffer(3 * _n + 2, 0), _steps(0), _cofactors(cofactors), _s{1, 0}, _t{0, 1} {
+                _a = _buffer.data();
+                _b = _a + _n + 1;
+                _next = _b + _n + 1;
+                _na = length(a);
+                _nb = length(b);
+                for (size_type i = 0; i < _na; ++i) _a[i] = a[i];
+                for (size_type i = 0; i < _nb; ++i) _b[i] = b[i];
+                // a < b takes a first step with quotient zero
+                if (kernel::compare(_a, _na, _b, _nb) < 0) {
+                    std::swap(_a, _b);
+                    std::swap(_na, _nb);
+                    std::swap(_s[0], _s[1]);
+                    std::swap(_t[0], _t[1]);
+                    _steps = 1;
+                }
+            }
+
+            // runs to the end, the gcd is left in a, b is zero
+            void run() {
+                while (!(_nb == 1 && _b[0] == 0)) {
+                    if (!_cofactors && _nb == 1) {
+                        const value_type g = kernel::gcd_1(kernel::mod_1(_a, _na, _b[0]), _b[0]);
+                        _a[0] = g;
+                        _na = 1;
+                        _b[0] = 0;
+                        break;
+                    }
+                    if (_na > _nb + 1 || !lehmer_step()) division_step();
+                }
+            }
+            natural_type gcd()const {
+                natural_type result;
+                result.assign_limbs(_a, _na);
+                return result;
+            }
+            // coefficient of a in the gcd
+            integer<natural_type> x()const {
+                return integer<natural_type>(_s[0], _steps % 2 == 1 && !_s[0].is_zero());
+            }
+            // coefficient of b in the gcd
+            integer<natural_type> y()const {
+                return integer<natural_type>(_t[0], _steps % 2 == 0 && !_t[0].is_zero());
+            }
+
+        private:
+            static size_type length(const natural_type& x)noexcept {
+                const size_type bits = x.bit_width();
+                return bits ? (bits + type_width - 1) / type_width : 1;
+            }
+            // one matrix from the leading bits, false when it makes no progress
+            bool lehmer_step() {
+                const size_type bits = _na * type_width - kernel::count_leading_zeros(_a[_na - 1]);
+                const size_type position = bits > 2 * type_width - 1 ? bits - (2 * type_width - 1) : 0;
+                const kernel::lehmer_matrix<value_type> m = kernel::lehmer<value_type>(
+                    kernel::leading_bits(_a, _na, position), kernel::leading_bits(_b, _nb, position), position == 0);
+                if (m.steps == 0) return false;
+                // both products run over the limbs of a, b is padded with zeros
+                for (size_type i = _nb; i < _na; ++i) _b[i] = 0;
+                value_type* const a = _a;
+                value_type* const b = _b;
+                if (m.steps % 2 == 0) {
+                    kernel::mul_sub_1(_next, a, m.s0, b, m.t0, _na);
+                    kernel::mul_sub_1(b, b, m.t1, a, m.s1, _na);
+                }
+                else {
+                    kernel::mul_sub_1(_next, b, m.t0, a, m.s0, _na);
+                    kernel::mul_sub_1(a, a, m.s1, b, m.t1, _na);
+                    _b = a;
+                }
+                _a = _next;
+                _next = m.steps % 2 == 0 ? a : b;
+                _nb = kernel::normalized_length(_b, _na);
+                _na = kernel::normalized_length(_a, _na);
+                if (_cofactors > 0) update(_s, m);
+                if (_cofactors > 1) update(_t, m);
+                _steps += m.steps;
+                return true;
+            }
+            // (a, b) = (b, a mod b)
+            void division_step() {
+                natural_type q;
+                if (_nb == 1) {
+                    if (_cofactors) {
+                        std::vector<value_type> quotient(_na);
+                        _a[0] = kernel::divrem_1(quotient.data(), _a, _na, _b[0]);
+                        q.assign_limbs(quotient.data(), _na);
+                    }
+                    else _a[0] = kernel::mod_1(_a, _na, _b[0]);
+                }
+                else {
+                    std::vector<value_type> quotient(_cofactors ? _na - _nb + 1 : 0), scratch(kernel::div_scratch_size(_na, _nb));
+                    kernel::div<policy_type>(_cofactors ? quotient.data() : nullptr, _a, _na, _b, _nb, scratch.data());
+                    if (_cofactors) q.assign_limbs(quotient.data(), quotient.size());
+                }
+                const size_type length = kernel::normalized_length(_a, _nb);
+                std::swap(_a, _b);
+                _na = _nb;
+                _nb = length;
+                if (_cofactors > 0) update(_s, q);
+                if (_cofactors > 1) update(_t, q);
+                ++_steps;
+            }
+            // the cofactors of the magnitudes share the recurrence of the remainders with all signs positive
+            static void update(natural_type (&c)[2], const kernel::lehmer_matrix<value_type>& m) {
+                natural_type c0(c[0]);
+                c0.mul_limb(m.s0).addmul_limb(c[1], m.t0);
+                c[0].mul_limb(m.s1).addmul_limb(c[1], m.t1);
+                c[1] = std::move(c[0]);
+                c[0] = std::move(c0);
+            }
+            static void update(natural_type (&c)[2], const natural_type& q) {
+                c[0].addmul(q, c[1]);
+                std::swap(c[0], c[1]);
+            }
+
+            size_type _n;
+            std::vector<value_type> _buffer;
+            value_type* _a;
+            value_type* _b;
+            value_type* _next;
+            size_type _na, _nb;
+            size_type _steps;
+            size_type _cofactors;
+            natural_type _s[2], _t[2];
+
+        };
+
+        // greatest common divisor, gcd(0, 0) = 0, NaN for NaN or infinite operands
+        template <typename T, class Container, class Policy>
+        natural<T, Container, Policy> gcd(const natural<T, Container, Policy>& a, const natural<T, Container, Policy>& b) {
+            using natural_type = natural<T, Container, Policy>;
+            if (a.is_NaN() || a.is_inf() || b.is_NaN() || b.is_inf()) return natural_type::NaN();
+            if (a.is_zero()) return b;
+            if (b.is_zero()) return a;
+            euclid<natural_type> steps(a, b, 0);
+            steps.run();
+            return steps.gcd();
+        }
+        // least common multiple, lcm(0, x) = 0
+        template <typename T, class Container, class Policy>
+        natural<T, Container, Policy> lcm(const natural<T, Container, Policy>& a, const natural<T, Container, Policy>& b) {
+            using natural_type = natural<T, Container, Policy>;
+            if (a.is_NaN() || a.is_inf() || b.is_NaN() || b.is_inf()) return natural_type::NaN();
+            if (a.is_zero() || b.is_zero()) return natural_type::zero();
+            natural_type result(a);
+            result /= gcd(a, b);
+            return result *= b;
+        }
+        // gcd with the coefficients of the Euclidean algorithm, |x| <= b / 2gcd and |y| <= a / 2gcd
+        // gcdext(a, 0) = {a, 1, 0}, NaN everywhere for NaN or infinite operands
+        template <typename T, class Container, class Policy>
+        gcdext_t<natural<T, Container, Policy>> gcdext(const natural<T, Container, Policy>& a, const natural<T, Container, Policy>& b) {
+            using natural_type = natural<T, Container, Policy>;
+            using integer_type = integer<natural_type>;
+            if (a.is_NaN() || a.is_inf() || b.is_NaN() || b.is_inf())
+                return {natural_type::NaN(), integer_type::quiet_NaN(), integer_type::quiet_NaN()};
+            if (b.is_zero()) return {a, integer_type(1), integer_type(0)};
+            euclid<natural_type> steps(a, b, 2);
+            steps.run();
+            return {steps.gcd(), steps.x(), steps.y()};
+        }
+        // x with a x = 1 modulo m, NaN when gcd(a, m) != 1 or m is zero
+        template <typename T, class Container, class Policy>
+        natural<T, Container, Policy> mod_inverse(const natural<T, Container, Policy>& a, const natural<T, Container, Policy>& m) {
+            using natural_type = natural<T, Container, Policy>;
+            if (a.is_NaN() || a.is_inf() || m.is_NaN() || m.is_inf() || m.is_zero()) return natural_type::NaN();
+            natural_type reduced(a);
+            if (reduced >= m) reduced %= m;
+            euclid<natural_type> steps(reduced, m, 1);
+            steps.run();
+            if (steps.gcd() != 1) return natural_type::NaN();
+            if (m == 1) return natural_type::zero();
+            const integer<natural_type> x = steps.x();
+            if (!x.is_negative()) return x.magnitude();
+            natural_type result(m);
+            return result -= x.magnitude();
+        }
+    }
+}
+
+#endif
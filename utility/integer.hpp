@@ -5,27 +5,37 @@
 
 namespace hwshqtb {
     namespace big_number {
-        template <std::size_t Extent = std::numeric_limits<type>::digits>
+        // sign and magnitude, every operation runs on the natural magnitude and fixes the sign afterwards
+        // zeros and infinities are signed, NaN carries the signaling flag in the sign
+        // bitwise operators and >> see the value in two's complement with infinite sign extension
+        template <class Natural = natural<>>
         class integer {
-            static_assert(Extent > 0, "");
+        public:
+            using natural_type = Natural;
+            using value_type = typename natural_type::value_type;
+            using size_type = typename natural_type::size_type;
+
+        private:
+            static constexpr std::size_t type_width = kernel::limb_traits<value_type>::width;
 
         public:
             constexpr integer()noexcept:
                 _signed(false), _number() {}
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr integer(Integer v)noexcept:
-                _signed(v < 0), _number(v < 0 ? -v : v) {}
+            HWSHQTB_CONSTEXPR14 integer(Integer v)noexcept:
+                _signed(v < 0), _number() {
+                using unsigned_type = std::make_unsigned_t<Integer>;
+                _number.assign(v < 0 ? (unsigned_type)(0 - (unsigned_type)v) : (unsigned_type)v);
+            }
+            HWSHQTB_CONSTEXPR14 integer(const natural_type& magnitude, bool negative = false)noexcept:
+                _signed(negative), _number(magnitude) {}
             constexpr integer(const integer&) = default;
-            constexpr integer(integer&& other)noexcept:
-                _signed(std::exchange(other._signed, false)), _number(std::move(other._number)) {}
+            constexpr integer(integer&&) = default;
             ~integer() = default;
 
             constexpr integer& operator=(const integer&) = default;
-            constexpr integer& operator=(integer&& other)noexcept {
-                operator=(other);
-                other.to_zero();
-                return *this;
-            }
+            constexpr integer& operator=(integer&&) = default;
+
             constexpr integer& to_quiet_NaN()noexcept {
                 _signed = false;
                 _number.to_NaN();
@@ -48,12 +58,12 @@ namespace hwshqtb {
             }
             constexpr integer& to_positive_infinity()noexcept {
                 _signed = false;
-                _number.to_infinity();
+                _number.to_inf();
                 return *this;
             }
             constexpr integer& to_negative_infinity()noexcept {
                 _signed = true;
-                _number.to_infinity();
+                _number.to_inf();
                 return *this;
             }
             constexpr integer& to_max()noexcept {
@@ -86,13 +96,20 @@ namespace hwshqtb {
                 return _number.is_zero() && _signed == true;
             }
             constexpr bool is_infinity()const noexcept {
-                return _number.is_infinity();
+                return _number.is_inf();
             }
             constexpr bool is_positive_infinity()const noexcept {
-                return _number.is_infinity() && _signed == false;
+                return _number.is_inf() && _signed == false;
             }
             constexpr bool is_negative_infinity()const noexcept {
-                return _number.is_infinity() && _signed == true;
+                return _number.is_inf() && _signed == true;
+            }
+            // sign bit, also set for negative zero
+            constexpr bool is_negative()const noexcept {
+                return _signed;
+            }
+            constexpr const natural_type& magnitude()const noexcept {
+                return _number;
             }
             static constexpr integer quiet_NaN()noexcept {
                 integer result;
@@ -102,6 +119,9 @@ namespace hwshqtb {
                 integer result;
                 return result.to_signaling_NaN();
             }
+            static constexpr integer zero()noexcept {
+                return positive_zero();
+            }
             static constexpr integer positive_zero()noexcept {
                 integer result;
                 return result.to_positive_zero();
@@ -127,53 +147,399 @@ namespace hwshqtb {
                 return result.to_max();
             }
 
+            HWSHQTB_CONSTEXPR14 integer& negate()noexcept {
+                if (!is_NaN()) _signed = !_signed;
+                return *this;
+            }
+
+            // any NaN operand gives a quiet NaN, otherwise the magnitude follows natural
+            // x + (-x) is +0 and x + (-inf) with x = +inf is NaN
+            HWSHQTB_CONSTEXPR14 integer& operator+=(const integer& other)noexcept {
+                return add(other, other._signed);
+            }
+            HWSHQTB_CONSTEXPR14 integer& operator-=(const integer& other)noexcept {
+                return add(other, !other._signed);
+            }
+            // the sign is the exclusive or of the signs, zeros and infinities included
+            HWSHQTB_CONSTEXPR14 integer& operator*=(const integer& other)noexcept {
+                if (is_NaN() || other.is_NaN()) return to_quiet_NaN();
+                _number *= other._number;
+                _signed = _signed != other._signed;
+                return quiet();
+            }
+            // truncates toward zero like the built-in types
+            HWSHQTB_CONSTEXPR14 integer& operator/=(const integer& other)noexcept {
+                return *this = div_trunc(other);
+            }
+            // the remainder of the truncating division, it has the sign of *this
+            HWSHQTB_CONSTEXPR14 integer& operator%=(const integer& other)noexcept {
+                div_trunc(other);
+                return *this;
+            }
+            // *this becomes x - q y with q = trunc(x / y), returns q
+            HWSHQTB_CONSTEXPR14 integer div_trunc(const integer& other)noexcept {
+                if (is_NaN() || other.is_NaN()) {
+                    to_quiet_NaN();
+                    return quiet_NaN();
+                }
+                integer quotient(_number.div(other._number), _signed != other._signed);
+                quiet();
+                return quotient.quiet();
+            }
+            // *this becomes x - q y with q = floor(x / y), returns q
+            // the remainder is zero or has the sign of y
+            HWSHQTB_CONSTEXPR14 integer div_floor(const integer& other)noexcept {
+                integer quotient = div_trunc(other);
+                if (is_NaN() || quotient.is_NaN() || is_zero() || _signed == other._signed) return quotient;
+                quotient._number += 1;
+                quotient._signed = true;
+                *this += other;
+                return quotient;
+            }
+
+            // two's complement views: -1 is all ones, ~x = -x - 1, infinities give NaN
+            template <class Operation>
+            HWSHQTB_CONSTEXPR14 integer& bitwise(const integer& other, Operation operation)noexcept {
+                if (is_NaN() || other.is_NaN() || is_infinity() || other.is_infinity()) return to_quiet_NaN();
+                // one more limb than either magnitude holds the sign
+                const size_type n = std::max(_number._length, other._number._length) + 1;
+                std::vector<value_type> x(n), y(n);
+                twos_complement(x.data(), n);
+                other.twos_complement(y.data(), n);
+                kernel::bitwise_n(x.data(), x.data(), y.data(), n, operation);
+                return assign_twos_complement(x.data(), n);
+            }
+            HWSHQTB_CONSTEXPR14 integer& operator&=(const integer& other)noexcept {
+                return bitwise(other, kernel::bit_and());
+            }
+            HWSHQTB_CONSTEXPR14 integer& operator|=(const integer& other)noexcept {
+                return bitwise(other, kernel::bit_or());
+            }
+            HWSHQTB_CONSTEXPR14 integer& operator^=(const integer& other)noexcept {
+                return bitwise(other, kernel::bit_xor());
+            }
+            HWSHQTB_CONSTEXPR14 integer& filp()noexcept {
+                if (is_NaN() || is_infinity()) return to_quiet_NaN();
+                if (_signed && !is_zero()) {
+                    _number -= 1;
+                    _signed = false;
+                }
+                else {
+                    _number += 1;
+                    _signed = true;
+                }
+                return *this;
+            }
+            // x << count is x 2^count, a negative count shifts the other way
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            HWSHQTB_CONSTEXPR14 integer& operator<<=(Integer count)noexcept {
+                if (count < 0) return shift_right((std::make_unsigned_t<Integer>)(0 - (std::make_unsigned_t<Integer>)count));
+                _number <<= count;
+                return *this;
+            }
+            // x >> count is floor(x / 2^count), a negative count shifts the other way
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            HWSHQTB_CONSTEXPR14 integer& operator>>=(Integer count)noexcept {
+                if (count < 0) {
+                    _number <<= (std::make_unsigned_t<Integer>)(0 - (std::make_unsigned_t<Integer>)count);
+                    return *this;
+                }
+                return shift_right((std::make_unsigned_t<Integer>)count);
+            }
+
+            friend HWSHQTB_CONSTEXPR14 integer operator+(const integer& x, const integer& y)noexcept {
+                integer result = x;
+                return result += y;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator+(integer&& x, const integer& y)noexcept {
+                return std::move(x += y);
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator-(const integer& x, const integer& y)noexcept {
+                integer result = x;
+                return result -= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator-(integer&& x, const integer& y)noexcept {
+                return std::move(x -= y);
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator*(const integer& x, const integer& y)noexcept {
+                integer result = x;
+                return result *= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator*(integer&& x, const integer& y)noexcept {
+                return std::move(x *= y);
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator/(const integer& x, const integer& y)noexcept {
+                integer result = x;
+                return result /= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator%(const integer& x, const integer& y)noexcept {
+                integer result = x;
+                return result %= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator&(const integer& x, const integer& y)noexcept {
+                integer result = x;
+                return result &= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator|(const integer& x, const integer& y)noexcept {
+                integer result = x;
+                return result |= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator^(const integer& x, const integer& y)noexcept {
+                integer result = x;
+                return result ^= y;
+            }
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            friend HWSHQTB_CONSTEXPR14 integer operator<<(const integer& x, Integer count)noexcept {
+                integer result = x;
+                return result <<= count;
+            }
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            friend HWSHQTB_CONSTEXPR14 integer operator>>(const integer& x, Integer count)noexcept {
+                integer result = x;
+                return result >>= count;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator~(const integer& x)noexcept {
+                integer result = x;
+                return result.filp();
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator+(const integer& x)noexcept {
+                return x;
+            }
+            friend HWSHQTB_CONSTEXPR14 integer operator-(const integer& x)noexcept {
+                integer result = x;
+                return result.negate();
+            }
+
+            // NaN is unordered, +0 == -0
+            friend HWSHQTB_CONSTEXPR14 bool operator==(const integer& x, const integer& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) == 0;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator!=(const integer& x, const integer& y)noexcept {
+                return !(x == y);
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator<(const integer& x, const integer& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) < 0;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator<=(const integer& x, const integer& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) <= 0;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator>(const integer& x, const integer& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) > 0;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator>=(const integer& x, const integer& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) >= 0;
+            }
+
+            // a leading '-' for negative values, then the magnitude as natural writes it
+            friend std::to_chars_result to_chars(char* first, char* last, const integer& x, int base = 10) {
+                if (x._signed && !x.is_NaN()) {
+                    if (first == last) return {last, std::errc::value_too_large};
+                    *first++ = '-';
+                }
+                return to_chars(first, last, x._number, base);
+            }
+            // an optional leading '-' followed by what natural accepts, x is untouched on failure
+            friend std::from_chars_result from_chars(const char* first, const char* last, integer& x, int base = 10) {
+                const bool negative = first != last && *first == '-';
+                natural_type magnitude;
+                std::from_chars_result result = from_chars(first + negative, last, magnitude, base);
+                if (result.ec == std::errc()) {
+                    x._number = std::move(magnitude);
+                    x._signed = negative && !x.is_NaN();
+                }
+                else if (result.ptr == first + negative) result.ptr = first;
+                return result;
+            }
+            template <class CharT, class Traits>
+            friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const integer& x) {
+                if (x._signed && !x.is_NaN()) os << os.widen('-');
+                return os << x._number;
+            }
+            template <class CharT, class Traits>
+            friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, integer& x) {
+                bool negative = false;
+                if (is.flags() & std::ios_base::skipws) is >> std::ws;
+                const typename Traits::int_type c = is.peek();
+                if (Traits::eq_int_type(c, Traits::to_int_type(is.widen('-'))) || Traits::eq_int_type(c, Traits::to_int_type(is.widen('+')))) {
+                    negative = Traits::eq_int_type(c, Traits::to_int_type(is.widen('-')));
+                    is.get();
+                }
+                natural_type magnitude;
+                // the magnitude follows the sign directly
+                const std::ios_base::fmtflags flags = is.flags();
+                is.unsetf(std::ios_base::skipws);
+                is >> magnitude;
+                is.flags(flags);
+                if (is) {
+                    x._number = std::move(magnitude);
+                    x._signed = negative && !x.is_NaN();
+                }
+                return is;
+            }
+
         private:
+            HWSHQTB_CONSTEXPR14 integer& quiet()noexcept {
+                if (is_NaN()) _signed = false;
+                return *this;
+            }
+            // -1, 0, 1 for |*this| <=> |other|, infinity above every finite magnitude
+            HWSHQTB_CONSTEXPR14 int compare_magnitude(const integer& other)const noexcept {
+                if (is_infinity() || other.is_infinity()) return (int)is_infinity() - (int)other.is_infinity();
+                return kernel::compare(_number._memory.data(), _number._length, other._number._memory.data(), other._number._length);
+            }
+            // -1, 0, 1 for *this <=> other, neither NaN
+            HWSHQTB_CONSTEXPR14 int compare(const integer& other)const noexcept {
+                if (is_zero() && other.is_zero()) return 0;
+                if (_signed != other._signed) return _signed ? -1 : 1;
+                return _signed ? -compare_magnitude(other) : compare_magnitude(other);
+            }
+            // *this += (-1)^sign |other|
+            HWSHQTB_CONSTEXPR14 integer& add(const integer& other, bool sign)noexcept {
+                if (is_NaN() || other.is_NaN()) return to_quiet_NaN();
+                if (_signed == sign) {
+                    _number += other._number;
+                    return *this;
+                }
+                const int order = compare_magnitude(other);
+                if (is_infinity() && other.is_infinity()) return to_quiet_NaN();
+                if (order > 0) _number -= other._number;
+                else if (order == 0) to_positive_zero();
+                else {
+                    // |*this| = |other| - |*this| in place
+                    natural_type& x = _number;
+                    const size_type n = other._number._length;
+                    if (other.is_infinity() || !x.reserve(n)) x.to_inf();
+                    else {
+                        value_type* r = x._memory.data();
+                        std::memset(r + x._length, 0, (n - x._length) * sizeof(value_type));
+                        kernel::sub_n(r, other._number._memory.data(), r, n);
+                        x._length = n;
+                        x.remove_zero();
+                    }
+                    _signed = sign;
+                }
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 integer& shift_right(std::size_t count)noexcept {
+                if (!_signed || is_zero() || is_infinity()) {
+                    _number >>= count;
+                    return *this;
+                }
+                // floor(-m / 2^count) = -(((m - 1) >> count) + 1)
+                _number -= 1;
+                _number >>= count;
+                _number += 1;
+                return *this;
+            }
+            // r[0, n) = *this in two's complement, n limbs above the magnitude
+            HWSHQTB_CONSTEXPR14 void twos_complement(value_type* r, size_type n)const noexcept {
+                for (size_type i = 0; i < n; ++i) r[i] = _number[i];
+                if (_signed && !is_zero()) {
+                    kernel::not_n(r, r, n);
+                    kernel::add_1(r, r, n, (value_type)1);
+                }
+            }
+            HWSHQTB_CONSTEXPR14 integer& assign_twos_complement(value_type* r, size_type n)noexcept {
+                _signed = (r[n - 1] >> (type_width - 1)) != 0;
+                if (_signed) {
+                    kernel::not_n(r, r, n);
+                    kernel::add_1(r, r, n, (value_type)1);
+                }
+                _number.assign_limbs(r, n);
+                return *this;
+            }
+
             bool _signed;
-            natural<Extent> _number;
+            natural_type _number;
 
         };
+
+        template <class Natural>
+        struct idiv_t {
+            integer<Natural> quot, rem;
+        };
+
+        // q = trunc(x / y), r = x - q y
+        template <class Natural>
+        HWSHQTB_CONSTEXPR14 idiv_t<Natural> divmod_trunc(const integer<Natural>& x, const integer<Natural>& y)noexcept {
+            idiv_t<Natural> result;
+            result.rem = x;
+            result.quot = result.rem.div_trunc(y);
+            return result;
+        }
+        // q = floor(x / y), r = x - q y
+        template <class Natural>
+        HWSHQTB_CONSTEXPR14 idiv_t<Natural> divmod_floor(const integer<Natural>& x, const integer<Natural>& y)noexcept {
+            idiv_t<Natural> result;
+            result.rem = x;
+            result.quot = result.rem.div_floor(y);
+            return result;
+        }
     }
 }
 
 namespace std {
-    template <size_t Extent>
-    class numeric_limits<hwshqtb::big_number::integer<Extent>>: public numeric_limits<std::size_t> {
+    template <class Natural>
+    constexpr hwshqtb::big_number::integer<Natural> abs(const hwshqtb::big_number::integer<Natural>& x)noexcept {
+        return hwshqtb::big_number::integer<Natural>(x.magnitude());
+    }
+    template <class Natural>
+    constexpr hwshqtb::big_number::idiv_t<Natural> div(const hwshqtb::big_number::integer<Natural>& x, const hwshqtb::big_number::integer<Natural>& y)noexcept {
+        return hwshqtb::big_number::divmod_trunc(x, y);
+    }
+    template <class Natural, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+    constexpr hwshqtb::big_number::integer<Natural> pow(const hwshqtb::big_number::integer<Natural>& x, Integer v) {
+        return hwshqtb::big_number::integer<Natural>(std::pow(x.magnitude(), v), x.is_negative() && (v & 1));
+    }
+
+    template <class Natural>
+    class numeric_limits<hwshqtb::big_number::integer<Natural>>: public numeric_limits<typename Natural::value_type> {
+        using integer_type = hwshqtb::big_number::integer<Natural>;
+        using value_type = typename Natural::value_type;
+
     public:
         static constexpr bool is_signed = true;
+        static constexpr bool is_bounded = !hwshqtb::big_number::is_growable_storage<typename Natural::container_type>::value;
         static constexpr bool has_infinity = true;
         static constexpr bool has_quiet_NaN = true;
         static constexpr bool has_signaling_NaN = true;
         static constexpr bool is_modulo = false;
-        static constexpr int digits = Extent * hwshqtb::big_number::lower_width;
+        static constexpr int digits = (int)(hwshqtb::big_number::static_capacity<typename Natural::container_type>::value * numeric_limits<value_type>::digits);
+        static constexpr int digits10 = (int)((long long)digits * 30103 / 100000);
 
-        static constexpr hwshqtb::big_number::integer<Extent> min() noexcept {
-            return hwshqtb::big_number::integer<Extent>::min();
+        static constexpr integer_type min() noexcept {
+            return integer_type::min();
         }
-        static constexpr hwshqtb::big_number::integer<Extent> lowest() noexcept {
-            return hwshqtb::big_number::integer<Extent>::min();
+        static constexpr integer_type lowest() noexcept {
+            return integer_type::min();
         }
-        static constexpr hwshqtb::big_number::integer<Extent> max() noexcept {
-            return hwshqtb::big_number::integer<Extent>::max();
+        static constexpr integer_type max() noexcept {
+            return integer_type::max();
         }
-        static constexpr hwshqtb::big_number::integer<Extent> epsilon() noexcept {
-            return hwshqtb::big_number::integer<Extent>::zero();
+        static constexpr integer_type epsilon() noexcept {
+            return integer_type::zero();
         }
-        static constexpr hwshqtb::big_number::integer<Extent> round_error() noexcept {
-            return hwshqtb::big_number::integer<Extent>::zero();
+        static constexpr integer_type round_error() noexcept {
+            return integer_type::zero();
         }
-        static constexpr hwshqtb::big_number::integer<Extent> infinity() noexcept {
-            return hwshqtb::big_number::integer<Extent>::positive_infinity();
+        static constexpr integer_type infinity() noexcept {
+            return integer_type::positive_infinity();
         }
-        static constexpr hwshqtb::big_number::integer<Extent> quiet_NaN() noexcept {
-            return hwshqtb::big_number::integer<Extent>::quiet_NaN();
+        static constexpr integer_type quiet_NaN() noexcept {
+            return integer_type::quiet_NaN();
         }
-        static constexpr hwshqtb::big_number::integer<Extent> signaling_NaN() noexcept {
-            return hwshqtb::big_number::integer<Extent>::signaling_NaN();
+        static constexpr integer_type signaling_NaN() noexcept {
+            return integer_type::signaling_NaN();
         }
-        static constexpr hwshqtb::big_number::integer<Extent> denorm_min() noexcept {
-            return hwshqtb::big_number::integer<Extent>::zero();
+        static constexpr integer_type denorm_min() noexcept {
+            return integer_type::zero();
         }
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,222 @@
+#ifndef HWSHQTB__BIG_NUMBER__MODULAR_HPP
+#define HWSHQTB__BIG_NUMBER__MODULAR_HPP
+
+#include "natural.hpp"
+#include <vector>
+
+namespace hwshqtb {
+    namespace big_number {
+        namespace kernel {
+            // -x^-1 modulo 2^width for odd x
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 T negative_inverse(T x)noexcept {
+                // x * x = 1 modulo 8, every Newton step doubles the correct bits
+                T inverse = x;
+                for (std::size_t bits = 3; bits < limb_traits<T>::width; bits *= 2)
+                    inverse = (T)(inverse * (T)(2 - (T)(x * inverse)));
+                return (T)(0 - inverse);
+            }
+            // Montgomery reduction, r[0, n) = t[0, 2n) / B^n mod m for t < m B^n and odd m, t is destroyed
+            // `inverse` is -m^-1 modulo B
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void redc(T* r, T* t, const T* m, std::size_t n, T inverse)noexcept {
+                T top = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    T carry = addmul_1(t + i, m, n, (T)(t[i] * inverse));
+                    top += add_1(t + i + n, t + i + n, n - i, carry);
+                }
+                // t / B^n < 2m
+                if (top || compare_n(t + n, m, n) >= 0) sub_n(r, t + n, m, n);
+                else
+                    for (std::size_t i = 0; i < n; ++i) r[i] = t[n + i];
+            }
+            // limbs of scratch needed by barrett_reduce<Policy>(r, x, m, n, mu, nmu, scratch)
+            constexpr std::size_t barrett_scratch_size(std::size_t n)noexcept {
+                return 6 * n + 8 + mul_scratch_size(n + 2, n + 2);
+            }
+            // Barrett reduction, r[0, n) = x[0, 2n) mod m for x < B^2n, mu[0, nmu) = floor(B^2n / m)
+            template <class Policy, typename T>
+            void barrett_reduce(T* r, const T* x, const T* m, std::size_t n, const T* mu, std::size_t nmu, T* scratch) {
+                // q = floor(floor(x / B^(n - 1)) mu / B^(n + 1)) is at most two below floor(x / m)
+                T* product = scratch;
+                T* remainder = product + n + 1 + nmu;
+                T* next = remainder + n + 1;
+                mul<Policy>(product, x + n - 1, n + 1, mu, nmu, next);
+                const T* q = product + n + 1;
+                const std::size_t nq = nmu < n + 1 ? nmu : n + 1;
+                // x - q m only matters modulo B^(n + 1)
+                mul<Policy>(next, q, nq, m, n, next + nq + n);
+                sub_n(remainder, x, next, n + 1);
+                while (remainder[n] || compare_n(remainder, m, n) >= 0)
+                    remainder[n] -= sub_n(remainder, remainder, m, n);
+                for (std::size_t i = 0; i < n; ++i) r[i] = remainder[i];
+            }
+        }
+
+        // modular arithmetic for a fixed modulus, the setup is paid once and shared by every operation
+        // mul_mod and sqr_mod reduce by Barrett, pow_mod works in Montgomery form for odd moduli
+        // a modulus of zero, NaN or infinity makes every result NaN
+        template <class Natural>
+        class montgomery {
+        public:
+            using natural_type = Natural;
+            using value_type = typename natural_type::value_type;
+            using size_type = std::size_t;
+            using policy_type = typename natural_type::policy_type;
+
+        private:
+            static constexpr std::size_t type_width = kernel::limb_traits<value_type>::width;
+
+        public:
+            explicit montgomery(const natural_type& modulus):
+                _modulus(modulus), _n(0), _inverse(0) {
+                if (modulus.is_NaN() || modulus.is_inf() || modulus.is_zero()) return;
+                _n = modulus._length;
+                _m.assign(modulus._memory.data(), modulus._memory.data() + _n);
+                // B^2n = mu m + R^2 mod m by one division
+                std::vector<value_type> power(2 * _n + 1, 0), scratch(kernel::divrem_scratch_size(2 * _n + 1, _n));
+                power[2 * _n] = 1;
+                _mu.assign(_n + 2, 0);
+                if (_n == 1) power[0] = kernel::divrem_1(_mu.data(), power.data(), 2 * _n + 1, _m[0]);
+                else kernel::divrem(_mu.data(), power.data(), 2 * _n + 1, _m.data(), _n, scratch.data());
+                _r2.assign(power.begin(), power.begin() + _n);
+                _mu.resize(kernel::normalized_length(_mu.data(), _n + 2));
+                if (_m[0] & 1) _inverse = kernel::negative_inverse(_m[0]);
+            }
+
+            const natural_type& modulus()const noexcept {
+                return _modulus;
+            }
+
+            // a * b mod m
+            natural_type mul_mod(const natural_type& a, const natural_type& b)const {
+                if (!_n || a.is_NaN() || a.is_inf() || b.is_NaN() || b.is_inf()) return natural_type::NaN();
+                std::vector<value_type> work(work_size(0));
+                value_type* x = work.data();
+                value_type* y = x + _n;
+                load(x, a);
+                load(y, b);
+                barrett_mul(x, x, y, y + _n);
+                return store(x);
+            }
+            // a^2 mod m
+            natural_type sqr_mod(const natural_type& a)const {
+                if (!_n || a.is_NaN() || a.is_inf()) return natural_type::NaN();
+                std::vector<value_type> work(work_size(0));
+                value_type* x = work.data();
+                load(x, a);
+                barrett_mul(x, x, x, x + 2 * _n);
+                return store(x);
+            }
+            // base^exponent mod m by left-to-right sliding windows over the bits of exponent
+            natural_type pow_mod(const natural_type& base, const natural_type& exponent)const {
+                if (!_n || base.is_NaN() || base.is_inf() || exponent.is_NaN() || exponent.is_inf()) return natural_type::NaN();
+                const size_type bits = exponent.bit_width();
+                const size_type window = bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 6 ? 2 : 1;
+                const size_type table_size = (size_type)1 << (window - 1);
+                std::vector<value_type> work(work_size(table_size + 2));
+                value_type* result = work.data();
+                value_type* square = result + _n;
+                value_type* table = square + _n;
+                value_type* next = table + table_size * _n;
+                const bool odd = (_m[0] & 1) != 0;
+                auto multiply = [this, odd, next](value_type* r, const value_type* x, const value_type* y) {
+                    if (odd) montgomery_mul(r, x, y, next);
+                    else barrett_mul(r, x, y, next);
+                };
+
+                if (bits == 0) {
+                    // 1 mod m
+                    for (size_type i = 0; i < _n; ++i) result[i] = 0;
+                    result[0] = 1;
+                    if (_n == 1 && _m[0] == 1) result[0] = 0;
+                    return store(result);
+                }
+                // table[i] = base^(2i + 1)
+                load(table, base);
+                if (odd) montgomery_mul(table, table, _r2.data(), next);
+                multiply(square, table, table);
+                for (size_type i = 1; i < table_size; ++i)
+                    multiply(table + i * _n, table + (i - 1) * _n, square);
+
+                bool started = false;
+                for (size_type i = bits; i > 0;) {
+                    if (!exponent_bit(exponent, i - 1)) {
+                        multiply(result, result, result);
+                        --i;
+                        continue;
+                    }
+                    // longest window ending with a one bit
+                    size_type length = i < window ? i : window;
+                    while (!exponent_bit(exponent, i - length)) --length;
+                    value_type value = 0;
+                    for (size_type j = 0; j < length; ++j)
+                        value = (value_type)(value << 1) | (value_type)exponent_bit(exponent, i - 1 - j);
+                    if (started) {
+                        for (size_type j = 0; j < length; ++j)
+                            multiply(result, result, result);
+                        multiply(result, result, table + (value >> 1) * _n);
+                    }
+                    else {
+                        for (size_type j = 0; j < _n; ++j) result[j] = table[(value >> 1) * _n + j];
+                        started = true;
+                    }
+                    i -= length;
+                }
+                if (odd) {
+                    for (size_type i = 0; i < _n; ++i) {
+                        next[i] = result[i];
+                        next[_n + i] = 0;
+                    }
+                    kernel::redc(result, next, _m.data(), _n, _inverse);
+                }
+                return store(result);
+            }
+
+        private:
+            size_type work_size(size_type values)const noexcept {
+                return (values + 3) * _n + 2 * _n + 1 + kernel::barrett_scratch_size(_n);
+            }
+            static bool exponent_bit(const natural_type& exponent, size_type position)noexcept {
+                return (exponent[position / type_width] >> (position % type_width)) & 1;
+            }
+            // r[0, n) = a mod m
+            void load(value_type* r, const natural_type& a)const {
+                if (a < _modulus) {
+                    for (size_type i = 0; i < _n; ++i) r[i] = a[i];
+                    return;
+                }
+                natural_type reduced(a);
+                reduced %= _modulus;
+                for (size_type i = 0; i < _n; ++i) r[i] = reduced[i];
+            }
+            natural_type store(const value_type* x)const {
+                natural_type result;
+                result.assign_limbs(x, _n);
+                return result;
+            }
+            // r = x y mod m, r may alias x or y
+            void barrett_mul(value_type* r, const value_type* x, const value_type* y, value_type* scratch)const {
+                value_type* product = scratch;
+                if (x == y) kernel::sqr<policy_type>(product, x, _n, product + 2 * _n);
+                else kernel::mul<policy_type>(product, x, _n, y, _n, product + 2 * _n);
+                kernel::barrett_reduce<policy_type>(r, product, _m.data(), _n, _mu.data(), _mu.size(), product + 2 * _n);
+            }
+            // r = x y / R mod m, r may alias x or y
+            void montgomery_mul(value_type* r, const value_type* x, const value_type* y, value_type* scratch)const {
+                value_type* product = scratch;
+                if (x == y) kernel::sqr<policy_type>(product, x, _n, product + 2 * _n);
+                else kernel::mul<policy_type>(product, x, _n, y, _n, product + 2 * _n);
+                kernel::redc(r, product, _m.data(), _n, _inverse);
+            }
+
+            natural_type _modulus;
+            size_type _n;
+            std::vector<value_type> _m, _r2, _mu;
+            value_type _inverse;
+
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,344 @@
+#ifndef HWSHQTB__BIG_NUMBER__MULTIPLY_HPP
+#define HWSHQTB__BIG_NUMBER__MULTIPLY_HPP
+
+#include "base.hpp"
+#include "ntt.hpp"
+#include "task_pool.hpp"
+
+namespace hwshqtb {
+    namespace big_number {
+        // what natural does with a result outside its range (a carry past the capacity, a negative difference)
+        // saturate: infinity and NaN as tabulated at each operator
+        // wrap: no special states, results are kept modulo 2^(width * capacity) like the built-in unsigned types
+        // and a division by zero gives zero, needs fixed storage
+        // assert: as wrap, but every such result fails an assertion first
+        struct overflow_saturate {};
+        struct overflow_wrap {};
+        struct overflow_assert {};
+
+        // operand lengths (in limbs) at which natural switches multiplication algorithm
+        // schoolbook below `Karatsuba`, Karatsuba below `Toom3`, Toom-3 below `NTT`, number theoretic transform above
+        template <std::size_t Karatsuba = 24, std::size_t Toom3 = 150, std::size_t NTT = 3500, class Overflow = overflow_saturate>
+        struct multiply_policy {
+            static_assert(Karatsuba >= 2 && Toom3 >= Karatsuba && Toom3 >= 4 && NTT >= Toom3, "");
+
+            static constexpr std::size_t karatsuba_threshold = Karatsuba;
+            static constexpr std::size_t toom3_threshold = Toom3;
+            static constexpr std::size_t ntt_threshold = NTT;
+            using overflow_policy = Overflow;
+        };
+        using wrapping_policy = multiply_policy<24, 150, 3500, overflow_wrap>;
+        using asserting_policy = multiply_policy<24, 150, 3500, overflow_assert>;
+
+        // overflow_policy of a Policy, overflow_saturate for policies that do not name one
+        template <class Policy, typename = void>
+        struct overflow_policy_of {
+            using type = overflow_saturate;
+        };
+        template <class Policy>
+        struct overflow_policy_of<Policy, std::void_t<typename Policy::overflow_policy>> {
+            using type = typename Policy::overflow_policy;
+        };
+        // Policy with its thresholds kept and the overflow policy replaced
+        template <class Policy, class Overflow>
+        struct rebind_overflow {
+            struct type: Policy {
+                using overflow_policy = Overflow;
+            };
+        };
+
+        // Policy whose products with both operands of at least `Grain` limbs are split into independent
+        // sub-products (Karatsuba and Toom-3 parts, blocks, NTT primes and butterfly blocks) run on task_pool::instance()
+        // smaller products stay serial, radix conversion splits its halves the same way
+        template <class Policy = multiply_policy<>, std::size_t Grain = 2048>
+        struct parallel_policy: Policy {
+            static_assert(Grain >= 1, "");
+
+            static constexpr std::size_t parallel_threshold = Grain;
+        };
+
+        // parallel_threshold of a Policy, 0 (always serial) for policies that do not name one
+        template <class Policy, typename = void>
+        struct parallel_threshold_of: std::integral_constant<std::size_t, 0> {};
+        template <class Policy>
+        struct parallel_threshold_of<Policy, std::void_t<decltype(Policy::parallel_threshold)>>: std::integral_constant<std::size_t, Policy::parallel_threshold> {};
+
+        namespace kernel {
+            // scratch limbs needed by mul<Policy>(r, x, nx, y, ny, scratch)
+            constexpr std::size_t mul_scratch_size(std::size_t nx, std::size_t ny)noexcept {
+                return 12 * (nx + ny) + 1024;
+            }
+            // whether sub-products of n limbs run in parallel under Policy
+            template <class Policy>
+            constexpr bool is_parallel(std::size_t n)noexcept {
+                return parallel_threshold_of<Policy>::value != 0 && n >= parallel_threshold_of<Policy>::value;
+            }
+
+            // inverse of 3 modulo 2^width
+            template <typename T>
+            constexpr T inverse_of_3(T inverse = 3, std::size_t bits = 3)noexcept {
+                return bits >= limb_traits<T>::width ? inverse : inverse_of_3<T>((T)(inverse * (T)(2 - (T)(3 * inverse))), bits * 2);
+            }
+            // r[0, n) = x[0, n) / 3 modulo 2^(width * n), exact when 3 divides x (also for two's complement negatives)
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void divexact_by3(T* r, const T* x, std::size_t n)noexcept {
+                constexpr T inverse = inverse_of_3<T>();
+                T borrow = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    T s = x[i];
+                    T next = s < borrow;
+                    s -= borrow;
+                    T q = (T)(s * inverse);
+                    r[i] = q;
+                    // 3q = s + high * 2^width, high is borrowed from the next limb
+                    T high = 0;
+                    mul_add(q, (T)3, (T)0, high);
+                    borrow = high + next;
+                }
+            }
+            // r[0, n) = -x[0, n) in two's complement
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void negate_n(T* r, const T* x, std::size_t n)noexcept {
+                T carry = 1;
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = add_carry((T)~x[i], (T)0, carry);
+            }
+            // arithmetic shift right by one bit of a two's complement number
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void half_signed_n(T* r, const T* x, std::size_t n)noexcept {
+                const T sign = x[n - 1] >> (limb_traits<T>::width - 1);
+                rshift(r, x, n, 1);
+                r[n - 1] |= sign << (limb_traits<T>::width - 1);
+            }
+            // r[0, n) += x[0, nx) with nx <= n, carry propagated but dropped above r[n - 1]
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void add_into(T* r, std::size_t n, const T* x, std::size_t nx)noexcept {
+                if (nx > n) nx = n;
+                add_1(r + nx, r + nx, n - nx, add_n(r, r, x, nx));
+            }
+            // r[0, n) -= x[0, nx) with nx <= n, borrow propagated but dropped above r[n - 1]
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void sub_into(T* r, std::size_t n, const T* x, std::size_t nx)noexcept {
+                if (nx > n) nx = n;
+                sub_1(r + nx, r + nx, n - nx, sub_n(r, r, x, nx));
+            }
+            template <class Policy, typename T>
+            void mul(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny, T* scratch);
+            template <class Policy, typename T>
+            void sqr(T* r, const T* x, std::size_t n, T* scratch);
+            // r[0, nx + ny) = x[0, nx) * y[0, ny) as a task of `group`, with scratch from the arena of the thread running it
+            template <class Policy, typename T>
+            void mul_task(task_group& group, T* r, const T* x, std::size_t nx, const T* y, std::size_t ny) {
+                group.run([=] {
+                    scratch_buffer<T> scratch(mul_scratch_size(nx, ny));
+                    mul<Policy>(r, x, nx, y, ny, scratch.data());
+                });
+            }
+
+            // x * y for nx >= ny by ny-limb blocks of x
+            template <class Policy, typename T>
+            void mul_blockwise(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny, T* scratch) {
+                if (is_parallel<Policy>(ny)) {
+                    // every block into its own product, then one carry pass
+                    const std::size_t blocks = (nx - 1) / ny;
+                    scratch_buffer<T> products(blocks * 2 * ny);
+                    task_group group;
+                    for (std::size_t b = 0; b < blocks; ++b) {
+                        const std::size_t i = (b + 1) * ny;
+                        mul_task<Policy>(group, products.data() + b * 2 * ny, y, ny, x + i, nx - i < ny ? nx - i : ny);
+                    }
+                    mul<Policy>(r, x, ny, y, ny, scratch);
+                    group.wait();
+                    for (std::size_t b = 0; b < blocks; ++b) {
+                        const std::size_t i = (b + 1) * ny, length = nx - i < ny ? nx - i : ny;
+                        const T* product = products.data() + b * 2 * ny;
+                        T carry = add_n(r + i, r + i, product, ny);
+                        add_1(r + i + ny, product + ny, length, carry);
+                    }
+                    return;
+                }
+                mul<Policy>(r, x, ny, y, ny, scratch);
+                T* product = scratch;
+                for (std::size_t i = ny; i < nx; i += ny) {
+                    const std::size_t length = nx - i < ny ? nx - i : ny;
+                    mul<Policy>(product, y, ny, x + i, length, scratch + 2 * ny);
+                    // r[i, i + ny) already holds the high half of the previous block
+                    T carry = add_n(r + i, r + i, product, ny);
+                    add_1(r + i + ny, product + ny, length, carry);
+                }
+            }
+
+            // Karatsuba for h < ny <= nx with h = ceil(nx / 2)
+            //     x * y = z0 + (z0 + z2 - (x0 - x1)(y0 - y1)) B^h + z2 B^2h
+            template <class Policy, typename T>
+            void mul_karatsuba(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny, T* scratch) {
+                const std::size_t h = (nx + 1) / 2, nx1 = nx - h, ny1 = ny - h;
+                T* dx = scratch;
+                T* dy = dx + h;
+                T* middle = dy + h;
+                T* sum = middle + 2 * h;
+                T* next = sum + 2 * h + 1;
+
+                // |x0 - x1| and |y0 - y1| with x1, y1 zero-extended to h limbs
+                for (std::size_t i = 0; i < h; ++i) dx[i] = i < nx1 ? x[h + i] : 0;
+                const bool x_negative = compare_n(x, dx, h) < 0;
+                if (x_negative) sub_n(dx, dx, x, h);
+                else sub_n(dx, x, dx, h);
+                // a square keeps squaring all the way down
+                const bool square = x == y && nx == ny;
+                bool y_negative = x_negative;
+                if (!square) {
+                    for (std::size_t i = 0; i < h; ++i) dy[i] = i < ny1 ? y[h + i] : 0;
+                    y_negative = compare_n(y, dy, h) < 0;
+                    if (y_negative) sub_n(dy, dy, y, h);
+                    else sub_n(dy, y, dy, h);
+                }
+
+                if (is_parallel<Policy>(ny1)) {
+                    task_group group;
+                    mul_task<Policy>(group, r, x, h, y, h);
+                    mul_task<Policy>(group, r + 2 * h, x + h, nx1, y + h, ny1);
+                    mul<Policy>(middle, dx, h, square ? dx : dy, h, next);
+                    group.wait();
+                }
+                else {
+                    mul<Policy>(r, x, h, y, h, next);
+                    mul<Policy>(r + 2 * h, x + h, nx1, y + h, ny1, next);
+                    mul<Policy>(middle, dx, h, square ? dx : dy, h, next);
+                }
+
+                // sum = z0 + z2 -/+ middle
+                const std::size_t nz2 = nx1 + ny1;
+                for (std::size_t i = 0; i < 2 * h; ++i) sum[i] = r[i];
+                sum[2 * h] = 0;
+                add_into(sum, 2 * h + 1, r + 2 * h, nz2);
+                if (x_negative == y_negative) sub_into(sum, 2 * h + 1, middle, 2 * h);
+                else add_into(sum, 2 * h + 1, middle, 2 * h);
+                add_into(r + h, nx + ny - h, sum, 2 * h + 1);
+            }
+
+            // Toom-3 for 2k < ny <= nx with k = ceil(nx / 3), evaluated at 0, 1, -1, 2 and infinity
+            template <class Policy, typename T>
+            void mul_toom3(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny, T* scratch) {
+                const std::size_t k = (nx + 2) / 3, nx2 = nx - 2 * k, ny2 = ny - 2 * k, n = nx + ny;
+                const std::size_t m = k + 1, l = 2 * k + 2;
+                const T* x0 = x;
+                const T* x1 = x + k;
+                const T* x2 = x + 2 * k;
+                const T* y0 = y;
+                const T* y1 = y + k;
+                const T* y2 = y + 2 * k;
+                T* px1 = scratch;
+                T* py1 = px1 + m;
+                T* pxm = py1 + m;
+                T* pym = pxm + m;
+                T* px2 = pym + m;
+                T* py2 = px2 + m;
+                T* v1 = py2 + m;
+                T* vm = v1 + l;
+                T* v2 = vm + l;
+                T* next = v2 + l;
+
+                // px1 = x0 + x1 + x2, pxm = |x0 - x1 + x2|, px2 = x0 + 2 x1 + 4 x2
+                auto evaluate = [k, m](T* p1, T* pm, T* p2, const T* a0, const T* a1, const T* a2, std::size_t n2)->bool {
+                    p1[k] = add(p1, a0, k, a2, n2);
+                    const bool negative = compare(p1, normalized_length(p1, m), a1, normalized_length(a1, k)) < 0;
+                    for (std::size_t i = 0; i < m; ++i) pm[i] = p1[i];
+                    sub_into(pm, m, a1, k);
+                    if (negative) negate_n(pm, pm, m);
+                    p1[k] += add_n(p1, p1, a1, k);
+                    for (std::size_t i = 0; i < k; ++i) p2[i] = a0[i];
+                    p2[k] = addmul_1(p2, a1, k, (T)2);
+                    T carry = addmul_1(p2, a2, n2, (T)4);
+                    add_1(p2 + n2, p2 + n2, m - n2, carry);
+                    return negative;
+                };
+                // a square evaluates once and squares the points, its value at -1 is never negative
+                const bool square = x == y && nx == ny;
+                const bool x_negative = evaluate(px1, pxm, px2, x0, x1, x2, nx2);
+                const bool negative = !square && x_negative != evaluate(py1, pym, py2, y0, y1, y2, ny2);
+
+                if (is_parallel<Policy>(ny2)) {
+                    task_group group;
+                    mul_task<Policy>(group, v1, px1, m, square ? px1 : py1, m);
+                    mul_task<Policy>(group, vm, pxm, m, square ? pxm : pym, m);
+                    mul_task<Policy>(group, v2, px2, m, square ? px2 : py2, m);
+                    mul_task<Policy>(group, r + 4 * k, x2, nx2, y2, ny2);
+                    mul<Policy>(r, x0, k, y0, k, next);
+                    group.wait();
+                }
+                else {
+                    mul<Policy>(v1, px1, m, square ? px1 : py1, m, next);
+                    mul<Policy>(vm, pxm, m, square ? pxm : pym, m, next);
+                    mul<Policy>(v2, px2, m, square ? px2 : py2, m, next);
+                    mul<Policy>(r, x0, k, y0, k, next);
+                    mul<Policy>(r + 4 * k, x2, nx2, y2, ny2, next);
+                }
+                if (negative) negate_n(vm, vm, l);
+                const T* v0 = r;
+                const T* vinf = r + 4 * k;
+                const std::size_t ninf = nx2 + ny2;
+
+                // interpolation in two's complement over l limbs
+                sub_n(v2, v2, vm, l);
+                divexact_by3(v2, v2, l);
+                sub_n(v1, v1, vm, l);
+                half_signed_n(v1, v1, l);
+                sub_into(vm, l, v0, 2 * k);
+                sub_n(v2, v2, vm, l);
+                half_signed_n(v2, v2, l);
+                sub_into(v2, l, vinf, ninf);
+                sub_into(v2, l, vinf, ninf);
+                add_n(vm, vm, v1, l);
+                sub_into(vm, l, vinf, ninf);
+                sub_n(v2, v2, v1, l);
+                sub_n(v1, v1, v2, l);
+
+                // r = v0 + c1 B^k + c2 B^2k + c3 B^3k + vinf B^4k
+                for (std::size_t i = 2 * k; i < 4 * k; ++i) r[i] = 0;
+                add_into(r + k, n - k, v1, l);
+                add_into(r + 2 * k, n - 2 * k, vm, l);
+                add_into(r + 3 * k, n - 3 * k, v2, l);
+            }
+
+            // r[0, nx + ny) = x[0, nx) * y[0, ny), r must not alias x or y
+            // scratch must hold mul_scratch_size(nx, ny) limbs
+            template <class Policy, typename T>
+            void mul(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny, T* scratch) {
+                if (x == y && nx == ny) {
+                    sqr<Policy>(r, x, nx, scratch);
+                    return;
+                }
+                if (nx < ny) {
+                    std::swap(x, y);
+                    std::swap(nx, ny);
+                }
+                if (ny < Policy::karatsuba_threshold)
+                    r[nx + ny - 1] = mul_basecase(r, x, nx, y, ny);
+                else if (ny >= Policy::ntt_threshold && nx + ny <= ntt_max_size)
+                    mul_ntt(r, x, nx, y, ny, is_parallel<Policy>(ny) ? parallel_threshold_of<Policy>::value : 0);
+                else if (2 * ny <= nx + 1)
+                    mul_blockwise<Policy>(r, x, nx, y, ny, scratch);
+                else if (ny < Policy::toom3_threshold || ny <= 2 * ((nx + 2) / 3))
+                    mul_karatsuba<Policy>(r, x, nx, y, ny, scratch);
+                else
+                    mul_toom3<Policy>(r, x, nx, y, ny, scratch);
+            }
+            // r[0, 2n) = x[0, n)^2, r must not alias x
+            // scratch must hold mul_scratch_size(n, n) limbs
+            template <class Policy, typename T>
+            void sqr(T* r, const T* x, std::size_t n, T* scratch) {
+                if (n < Policy::karatsuba_threshold)
+                    sqr_basecase(r, x, n);
+                else if (n >= Policy::ntt_threshold && 2 * n <= ntt_max_size)
+                    mul_ntt(r, x, n, x, n, is_parallel<Policy>(n) ? parallel_threshold_of<Policy>::value : 0);
+                else if (n < Policy::toom3_threshold || n <= 2 * ((n + 2) / 3))
+                    mul_karatsuba<Policy>(r, x, n, x, n, scratch);
+                else
+                    mul_toom3<Policy>(r, x, n, x, n, scratch);
+            }
+        }
+    }
+}
+
+#endif
@@ -1,17 +1,41 @@
 #ifndef HWSHQTB__BIG_NUMBER__NATURAL_HPP
 #define HWSHQTB__BIG_NUMBER__NATURAL_HPP
 
-#include "base.hpp"
+#include "divide.hpp"
+#include "radix.hpp"
+#include "storage.hpp"
+#include <climits>
 #include <iostream>
 #include <array>
 #include <list>
+#include <vector>
+#include <charconv>
 
 namespace hwshqtb {
     namespace big_number {
-        template <typename T = std::size_t, class Container = std::array<T, 1024 / sizeof(T) / CHAR_BIT>>
+        template <class Natural>
+        class montgomery;
+        template <class Natural>
+        class product_expression;
+        template <class Natural>
+        class integer;
+
+        // outcome of to_binary and from_binary, in the manner of std::to_chars_result and std::from_chars_result
+        struct to_binary_result {
+            unsigned char* ptr;
+            std::errc ec;
+        };
+        struct from_binary_result {
+            const unsigned char* ptr;
+            std::errc ec;
+        };
+
+        template <typename T = std::size_t, class Container = std::array<T, 1024 / sizeof(T) / CHAR_BIT>, class Policy = multiply_policy<>>
         class natural {
         public:
             using container_type = Container;
+            using policy_type = Policy;
+            using overflow_policy = typename overflow_policy_of<policy_type>::type;
             using value_type = typename container_type::value_type;
             using size_type = typename container_type::size_type;
             using reference = typename container_type::reference;
@@ -19,17 +43,26 @@ namespace hwshqtb {
 
         private:
             using value_type_property = std::numeric_limits<value_type>;
+            using limb_traits = kernel::limb_traits<value_type>;
+            // growable twin with NaN and infinity, for the root search that relies on saturation
+            using saturating_type = natural<value_type, std::vector<value_type>, typename rebind_overflow<policy_type, overflow_saturate>::type>;
+
+            template <typename Integer>
+            static constexpr std::size_t integer_length = (std::numeric_limits<Integer>::digits + std::numeric_limits<Integer>::is_signed + value_type_property::digits - 1) / value_type_property::digits;
 
         public:
             static_assert(std::is_same<T, value_type>::value, "");
             static_assert(std::is_integral<value_type>::value && !value_type_property::is_signed, "");
+            static_assert(!std::is_same<overflow_policy, overflow_wrap>::value || !is_growable_storage<container_type>::value, "wrapping needs a fixed capacity");
+
+            // false under overflow_wrap and overflow_assert, is_NaN() and is_inf() are then constant false
+            // and every special value branch compiles away
+            static constexpr bool has_special = std::is_same<overflow_policy, overflow_saturate>::value;
+            static constexpr bool is_asserting = std::is_same<overflow_policy, overflow_assert>::value;
 
+            // every limb holds full `type_width` bits, i.e. the number is represented in base 2^type_width
             static constexpr value_type type_width = value_type_property::digits;
-            static constexpr value_type lower_width = type_width / 2;
-            static constexpr value_type upper_width = type_width - lower_width;
-            static constexpr value_type base = (value_type)1 << lower_width;
-            static constexpr value_type lower_half = ((value_type)1 << lower_width) - 1;
-            static constexpr value_type upper_half = (((value_type)1 << upper_width) - 1) << lower_width;
+            static constexpr value_type limb_max = value_type_property::max();
 
             template <typename... Ts>
             HWSHQTB_CONSTEXPR14 natural(value_type v = 0, Ts&&... ts):
@@ -38,9 +71,20 @@ namespace hwshqtb {
             }
             template <typename... Ts>
             HWSHQTB_CONSTEXPR14 natural(in_place_t, Ts&&... ts) :
-                _memory(std::forward<Ts>(ts)...), _length(remove_zero(_memory.size())) {}
+                _memory(std::forward<Ts>(ts)...), _length(kernel::normalized_length(_memory.data(), _memory.size())) {}
+            template <typename... Ts>
+            HWSHQTB_CONSTEXPR14 explicit natural(limb_view<value_type> limbs, Ts&&... ts):
+                _memory(std::forward<Ts>(ts)...), _length(0) {
+                assign(limbs);
+            }
             constexpr natural(const natural&) = default;
-            constexpr natural(natural&&) = default;
+            // the source is left zero, a growable container comes back empty from the move and gets one limb again
+            HWSHQTB_CONSTEXPR14 natural(natural&& other)noexcept:
+                _memory(std::move(other._memory)), _length(other._length) {
+                if (other.reserve(1)) other.to_zero();
+                // not even one limb could be allocated, NaN needs none
+                else other._length = 0;
+            }
 
             template <typename Integer, typename... Ts, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
             HWSHQTB_CONSTEXPR14 natural& operator=(Integer v)
@@ -52,33 +96,65 @@ namespace hwshqtb {
 
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
             HWSHQTB_CONSTEXPR14 void assign(Integer v)noexcept {
-                if (v < 0) to_inf();
-                else if (v == 0) to_zero();
+                value_type limbs[integer_length<Integer>] = {};
+                if (v >= 0) assign_limbs(limbs, split(v, limbs));
+                else if HWSHQTB_CONSTEXPR17(has_special) to_inf();
                 else {
-                    _length = 0;
-                    while (v != 0 && _length < _memory.size()) {
-                        _memory[_length++] = v & lower_half;
-                        v = v / base;
-                    }
-                    if (v) to_inf();
+                    // two's complement
+                    const size_type length = split(v, limbs);
+                    to_zero();
+                    sub_limbs(limbs, length);
                 }
             }
 
+            // *this = y[0, ny), least significant limb first, infinity when the storage cannot hold it
+            HWSHQTB_CONSTEXPR14 void assign_limbs(const value_type* y, size_type ny)noexcept {
+                ny = kernel::normalized_length(y, ny);
+                if (!reserve(ny)) {
+                    assign_overflow(y, ny);
+                    return;
+                }
+                for (size_type i = 0; i < ny; ++i)
+                    _memory[i] = y[i];
+                _length = ny;
+            }
+            // *this = the limbs of `y`, copied once out of the caller's buffer, an empty view gives zero
+            HWSHQTB_CONSTEXPR14 void assign(limb_view<value_type> y)noexcept {
+                y = y.normalized();
+                if (y.empty()) assign((value_type)0);
+                else assign_limbs(y.data(), y.size());
+            }
+
             constexpr value_type operator[](std::size_t index)const noexcept {
                 return index >= _length ? 0 : _memory[index];
             }
+            // the limbs in use, least significant first, empty for NaN and infinity
+            // valid until *this is modified
+            constexpr limb_view<value_type> limbs()const noexcept {
+                return is_NaN() || is_inf() ? limb_view<value_type>() : limb_view<value_type>(_memory.data(), _length);
+            }
 
             constexpr bool is_NaN()const noexcept {
-                return _length == 0;
+                return has_special && _length == 0;
             }
             constexpr bool is_inf()const noexcept {
-                return _length == _memory.size() + 1;
+                return has_special && _length == _memory.size() + 1;
             }
             constexpr bool is_zero()const noexcept {
                 return _length == 1 && _memory[0] == 0;
             }
+            // number of significant bits, 0 for zero and special values
+            HWSHQTB_CONSTEXPR14 size_type bit_width()const noexcept {
+                if (is_NaN() || is_inf() || is_zero()) return 0;
+                return _length * type_width - kernel::count_leading_zeros(_memory[_length - 1]);
+            }
 
+            // without special values NaN gives zero and infinity the largest value, overflow_assert asserts first
             constexpr natural& to_NaN()noexcept {
+                if HWSHQTB_CONSTEXPR17(!has_special) {
+                    assert(!is_asserting && "hwshqtb::big_number::natural: invalid operation");
+                    return to_zero();
+                }
                 _length = 0;
                 return *this;
             }
@@ -88,13 +164,18 @@ namespace hwshqtb {
                 return *this;
             }
             constexpr natural& to_inf()noexcept {
+                if HWSHQTB_CONSTEXPR17(!has_special) {
+                    assert(!is_asserting && "hwshqtb::big_number::natural: overflow");
+                    return to_max();
+                }
                 _length = _memory.size() + 1;
                 return *this;
             }
+            // largest value the current capacity holds
             constexpr natural& to_max()noexcept {
                 _length = 0;
                 while (_length < _memory.size())
-                    _memory[_length++] = lower_half;
+                    _memory[_length++] = limb_max;
                 return *this;
             }
 
@@ -108,20 +189,11 @@ namespace hwshqtb {
                 if (other.is_NaN()) return to_NaN();
                 if (is_inf()) return *this;
                 if (other.is_inf()) return to_inf();
-                if (is_zero()) return operator=(other);
-                if (other.is_zero()) return *this;
-                _length = std::max(_length, other._length);
-                value_type carry = 0;
-                for (std::size_t i = 0; i < _length; ++i) {
-                    carry = ((_memory[i] += other[i] + carry) & upper_half) >> lower_width;
-                    _memory[i] &= lower_half;
-                }
-                if (carry) {
-                    if (_length < _memory.size())
-                        _memory[_length] = carry;
-                    ++_length;
-                }
-                return *this;
+                return add_limbs(other._memory.data(), other._length);
+            }
+            // *this += x * y accumulated in place
+            HWSHQTB_CONSTEXPR14 natural& operator+=(product_expression<natural>&& other)noexcept {
+                return addmul(other._x, other._y);
             }
             // \    0   NaN inf x
             // 0    0   NaN inf inf
@@ -132,22 +204,8 @@ namespace hwshqtb {
                 if (is_NaN()) return *this;
                 if (other.is_NaN() || (is_inf() && other.is_inf())) return to_NaN();
                 if (is_inf()) return *this;
-                if (other.is_zero()) return *this;
-                if (other.is_inf() || (is_zero() && !other.is_zero()) || _length < other._length) return to_inf();
-                value_type borrow = 0;
-                for (std::size_t i = 0; i < _length; ++i) {
-                    if (_memory[i] < borrow + other[i]) {
-                        _memory[i] += base - borrow - other[i];
-                        borrow = 1;
-                    }
-                    else {
-                        _memory[i] -= borrow + other[i];
-                        borrow = 0;
-                    }
-                }
-                if (borrow == 1) to_inf();
-                else remove_zero();
-                return *this;
+                if (other.is_inf()) return to_inf();
+                return sub_limbs(other._memory.data(), other._length);
             }
             // \    0   NaN inf x
             // 0    0   NaN NaN 0
@@ -160,185 +218,224 @@ namespace hwshqtb {
                 if (is_zero()) return *this;
                 if (other.is_zero()) return to_zero();
                 if (is_inf()) return *this;
-                if (other.is_inf() || _length + other._length >= _memory.size() + 2) return to_inf();
-                natural x(*this);
-                std::memset(_memory, 0, (_length + other._length - 1) * type_width);
-                for (std::size_t i = 0; i < other._length; ++i) {
-                    for (std::size_t j = 0; j < other._length; ++j) {
-                        if ((_memory[i + j] += x[i] * other[j]) & upper_half) {
-                            if (i + j + 1 == _memory.size()) return to_inf();
-                            _memory[i + j + 1] += _memory[i + j] >> lower_width;
-                            _memory[i + j] &= lower_half;
-                        }
-                    }
+                if (other.is_inf()) return to_inf();
+                return mul_limbs(other._memory.data(), other._length);
+            }
+            // arithmetic on limbs read in place, e.g. from a memory mapped file, `other` is finite
+            HWSHQTB_CONSTEXPR14 natural& operator+=(limb_view<value_type> other)noexcept {
+                other = other.normalized();
+                if (is_NaN() || is_inf() || other.empty()) return *this;
+                return add_limbs(other.data(), other.size());
+            }
+            HWSHQTB_CONSTEXPR14 natural& operator-=(limb_view<value_type> other)noexcept {
+                other = other.normalized();
+                if (is_NaN() || is_inf() || other.empty()) return *this;
+                return sub_limbs(other.data(), other.size());
+            }
+            HWSHQTB_CONSTEXPR14 natural& operator*=(limb_view<value_type> other)noexcept {
+                other = other.normalized();
+                if (is_NaN() || is_zero()) return *this;
+                if (other.empty()) return is_inf() ? to_NaN() : to_zero();
+                if (is_inf()) return *this;
+                return mul_limbs(other.data(), other.size());
+            }
+            // *this *= *this, large operands take a single forward transform
+            HWSHQTB_CONSTEXPR14 natural& square()noexcept {
+                return *this *= *this;
+            }
+            // *this += x * y without a temporary product, special values as `*this += x * y`
+            // below the Karatsuba threshold the rows of x * y are accumulated straight into *this
+            HWSHQTB_CONSTEXPR14 natural& addmul(const natural& x, const natural& y)noexcept {
+                if (is_NaN()) return *this;
+                if (x.is_NaN() || y.is_NaN() || (x.is_zero() && y.is_inf()) || (y.is_zero() && x.is_inf())) return to_NaN();
+                if (is_inf()) return *this;
+                if (x.is_inf() || y.is_inf()) return to_inf();
+                if (x.is_zero() || y.is_zero()) return *this;
+                const size_type nx = x._length, ny = y._length;
+                // one spare limb for the carry when the capacity allows it, otherwise a carry-out is an overflow
+                size_type length = std::max(_length, nx + ny);
+                if (reserve(length + 1)) ++length;
+                if (&x == this || &y == this || std::min(nx, ny) >= policy_type::karatsuba_threshold || !reserve(length)) {
+                    scratch_buffer<value_type> product(nx + ny + kernel::mul_scratch_size(nx, ny));
+                    kernel::mul<policy_type>(product.data(), x._memory.data(), nx, y._memory.data(), ny, product.data() + nx + ny);
+                    return add_limbs(product.data(), kernel::normalized_length(product.data(), nx + ny));
+                }
+                value_type* r = _memory.data();
+                std::memset(r + _length, 0, (length - _length) * sizeof(value_type));
+                value_type overflow = 0;
+                for (size_type j = 0; j < ny; ++j) {
+                    const value_type carry = kernel::addmul_1(r + j, x._memory.data(), nx, y._memory[j]);
+                    // the carry rarely ripples past the next limb
+                    if ((r[j + nx] += carry) < carry)
+                        overflow |= kernel::add_1(r + j + nx + 1, r + j + nx + 1, length - j - nx - 1, (value_type)1);
                 }
+                _length = length;
+                if (overflow) return out_of_range();
+                remove_zero();
+                return *this;
+            }
+            // *this -= x * y without a temporary product, special values as `*this -= x * y`
+            HWSHQTB_CONSTEXPR14 natural& submul(const natural& x, const natural& y)noexcept {
+                if (is_NaN()) return *this;
+                if (x.is_NaN() || y.is_NaN() || (x.is_zero() && y.is_inf()) || (y.is_zero() && x.is_inf())) return to_NaN();
+                if (x.is_inf() || y.is_inf()) return is_inf() ? to_NaN() : to_inf();
+                if (x.is_zero() || y.is_zero()) return *this;
+                if (is_inf()) {
+                    // NaN when x * y overflows as well
+                    natural product;
+                    product.assign_product(x, y);
+                    return product.is_inf() ? to_NaN() : *this;
+                }
+                const size_type nx = x._length, ny = y._length;
+                // x * y >= B^(nx + ny - 2) > *this
+                if HWSHQTB_CONSTEXPR17(has_special)
+                    if (_length < nx + ny - 1) return to_inf();
+                // a wrapped difference needs the whole product
+                if (!has_special || &x == this || &y == this || std::min(nx, ny) >= policy_type::karatsuba_threshold) {
+                    scratch_buffer<value_type> product(nx + ny + kernel::mul_scratch_size(nx, ny));
+                    kernel::mul<policy_type>(product.data(), x._memory.data(), nx, y._memory.data(), ny, product.data() + nx + ny);
+                    return sub_limbs(product.data(), kernel::normalized_length(product.data(), nx + ny));
+                }
+                value_type* r = _memory.data();
+                value_type borrow = 0;
+                for (size_type j = 0; j < ny; ++j) {
+                    const value_type rest = kernel::submul_1(r + j, x._memory.data(), nx, y._memory[j]);
+                    borrow |= j + nx < _length ? kernel::sub_1(r + j + nx, r + j + nx, _length - j - nx, rest) : rest;
+                }
+                if (borrow) return to_inf();
+                remove_zero();
                 return *this;
             }
+            // *this *= m
+            HWSHQTB_CONSTEXPR14 natural& mul_limb(value_type m)noexcept {
+                if (is_NaN() || is_zero()) return *this;
+                if (is_inf()) return m == 0 ? to_NaN() : *this;
+                return mul_add_limb(m, 0);
+            }
+            // *this += x * m in one carry pass over x, x may be *this
+            HWSHQTB_CONSTEXPR14 natural& addmul_limb(const natural& x, value_type m)noexcept {
+                if (is_NaN()) return *this;
+                if (x.is_NaN() || (x.is_inf() && m == 0)) return to_NaN();
+                if (is_inf()) return *this;
+                if (x.is_inf()) return to_inf();
+                if (x.is_zero() || m == 0) return *this;
+                const size_type nx = x._length;
+                if (!reserve(nx)) return to_inf();
+                value_type* r = _memory.data();
+                if (_length < nx) {
+                    std::memset(r + _length, 0, (nx - _length) * sizeof(value_type));
+                    _length = nx;
+                }
+                value_type carry = kernel::addmul_1(r, x._memory.data(), nx, m);
+                carry = kernel::add_1(r + nx, r + nx, _length - nx, carry);
+                if (carry) {
+                    if (!reserve(_length + 1)) return out_of_range();
+                    _memory[_length++] = carry;
+                }
+                return *this;
+            }
+            // *this <<= count and *this >>= count with the count as a plain size
+            HWSHQTB_CONSTEXPR14 natural& shift_left(size_type count)noexcept {
+                if (is_NaN() || is_inf()) return *this;
+                return shift_left_bits(count);
+            }
+            HWSHQTB_CONSTEXPR14 natural& shift_right(size_type count)noexcept {
+                if (is_NaN() || is_inf()) return *this;
+                return shift_right_bits(count);
+            }
+            // *this = x << count straight from the limbs of x, without copying x first, x may be *this
+            HWSHQTB_CONSTEXPR14 natural& shift_left(const natural& x, size_type count)noexcept {
+                if (x.is_NaN()) return to_NaN();
+                if (x.is_inf()) return to_inf();
+                return shift_left_bits(x, count);
+            }
+            HWSHQTB_CONSTEXPR14 natural& shift_right(const natural& x, size_type count)noexcept {
+                if (x.is_NaN()) return to_NaN();
+                if (x.is_inf()) return to_inf();
+                return shift_right_bits(x, count);
+            }
             // \    0   NaN inf x
             // 0    NaN NaN 0   0
             // NaN  NaN NaN NaN NaN
             // inf  NaN NaN NaN inf
             // x    NaN NaN 0   ?
-            constexpr natural& operator/=(const natural& other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator/=(const natural& other)noexcept {
                 if (is_NaN()) return *this;
                 if (other.is_NaN() || other.is_zero() || (is_inf() && other.is_inf())) return to_NaN();
                 if (is_zero()) return *this;
                 if (other.is_inf() || operator<(other)) return to_zero();
                 if (is_inf()) return *this;
-                natural result;
-                value_type v = other[other._length - 1] + 1;
-                do {
-                    value_type remainder = 0, index = _length, result_index = _length - other._length + 1;
-                    while (remainder < v) {
-                        remainder <<= lower_width;
-                        remainder += _memory[--index];
-                        if (--result_index == 0) break;
-                    }
-                    if (remainder < v) break;
-                    value_type x = remainder / v;
-                    result._memory[result_index] = result[result_index] + x;
-                    natural mul_other(other);
-                    mul_other.base_multiply(x);
-                    mul_other.shift_left(result_index);
-                    operator-=(mul_other);
-                }
-                while (true);
-                if (*this > other)
-                    ++result;
-                *this = result;
-                remove_zero();
-                return *this;
+                return div_limbs(other._memory.data(), other._length);
             }
             // \    0   NaN inf x
             // 0    NaN NaN 0   0
             // NaN  NaN NaN NaN NaN
             // inf  NaN NaN NaN NaN
             // x    NaN NaN 0   ?
-            constexpr natural& operator%=(const natural& other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator%=(const natural& other)noexcept {
                 if (is_NaN()) return *this;
                 if (other.is_NaN() || other.is_zero() || is_inf()) return to_NaN();
                 if (is_zero() || other.is_inf() || operator<(other)) return *this;
-                std::size_t i = _length + 1 - other._length;
-                do {
-                    --i;
-                    natural x{_memory, i, _length};
-                    while (x >= other)
-                        x -= other;
-                    for (std::size_t j = 0; j < x._length; ++j)
-                        _memory[i + j] = x._memory[j];
-                    _length = i + x._length;
-                }
-                while (i > 0);
-                while (_length > 0 && _memory[_length - 1] == 0) --_length;
+                divide(other._memory.data(), other._length, nullptr);
                 return *this;
             }
-            constexpr natural& operator&=(const natural& other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator&=(const natural& other)noexcept {
                 if (is_NaN()) return *this;
                 if (other.is_NaN()) return to_NaN();
                 if (is_zero()) return *this;
                 if (other.is_zero()) return to_zero();
                 if (is_inf()) return *this;
                 if (other.is_inf()) return to_inf();
-                _length = std::max(_length, other._length);
-                for (int i = 0; i < _length; ++i)
-                    _memory[i] &= other[i];
-                while (_length > 1 && _memory[_length - 1] == 0) --_length;
-                return *this;
+                return and_limbs(other._memory.data(), other._length);
             }
-            constexpr natural& operator|=(const natural& other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator|=(const natural& other)noexcept {
                 if (is_NaN()) return *this;
                 if (other.is_NaN()) return to_NaN();
                 if (is_inf()) return *this;
                 if (other.is_inf()) return to_inf();
-                if (is_zero()) return operator=(other);
-                if (other.is_zero()) return *this;
-                _length = std::max(_length, other._length);
-                for (int i = 0; i < _length; ++i)
-                    _memory[i] |= other[i];
-                while (_length > 1 && _memory[_length - 1] == 0) --_length;
-                return *this;
+                return or_limbs(other._memory.data(), other._length);
             }
-            constexpr natural& operator^=(const natural& other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator^=(const natural& other)noexcept {
                 if (is_NaN() || is_inf()) return *this;
                 if (other.is_NaN()) return to_NaN();
                 if (other.is_inf()) return to_inf();
-                if (is_zero()) return operator=(other).flip();
-                _length = std::max(_length, other._length);
-                for (int i = 0; i < _length; ++i)
-                    _memory[i] ^= other[i];
-                while (_length > 1 && _memory[_length - 1] == 0) --_length;
-                return *this;
+                return xor_limbs(other._memory.data(), other._length);
             }
-            constexpr natural& operator<<=(const natural& other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator<<=(const natural& other)noexcept {
                 if (is_NaN()) return *this;
                 if (other.is_NaN()) return to_NaN();
                 if (is_zero() || other.is_zero() || is_inf()) return *this;
                 if (other.is_inf()) return to_inf();
-                natural x(other);
-                value_type remaining = x.div(lower_width);
-                value_type block = x;
-                if (block) {
-                    std::size_t index = _length + block - 1, index2 = _length - 1;
-                    if (index >= _memory.size() + 1) return to_inf();
-                    while (index != block - 1)
-                        _memory[index--] = _memory[index2--];
-                    ++index;
-                    do _memory[--index] = 0;
-                    while (index > 0);
-                }
-                if (remaining) {
-                    std::size_t index = _length + block - 1;
-                    if ((_memory[index] >> (lower_width - remaining)) && index == _memory.size()) return to_inf();
-                    ++index;
-                    do {
-                        --index;
-                        _memory[index + 1] |= (_memory[index] >> (lower_width - remaining));
-                        _memory[index] = (_memory[index] << remaining) & lower_half;
-                    }
-                    while (index > 0);
+                size_type count = 0;
+                if (!other.to_size(count)) {
+                    if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                    count = std::numeric_limits<size_type>::max();
                 }
-                _length = _memory[_length + block] ? _length + block : _length + block - 1;
-                return *this;
+                return shift_left_bits(count);
             }
-            constexpr natural& operator>>=(const natural& other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator>>=(const natural& other)noexcept {
                 if (is_NaN()) return *this;
                 if (other.is_NaN()) return to_NaN();
                 if (is_zero() || other.is_zero() || is_inf()) return *this;
                 if (other.is_inf()) return to_zero();
-                natural x(other);
-                value_type remaining = x.div(lower_width);
-                value_type block = x;
-                if (block) {
-                    std::size_t index = 0, index2 = block;
-                    if (block >= _length) return to_zero();
-                    while (index2 != _length)
-                        _memory[index++] = _memory[index2++];
-                    while (index != _length)
-                        _memory[index++] = 0;
-                }
-                if (remaining) {
-                    std::size_t index = 0;
-                    if (_length == 1 && !(_memory[0] >> remaining)) return to_zero();
-                    while (index < _length - block) {
-                        _memory[index] >>= remaining;
-                        _memory[index] |= _memory[index + 1] >> (lower_width - remaining);
-                    }
-                }
-                _length = _memory[_length - block - 1] ? _length - block : _length - block - 1;
-                if (_length == 0) _length = 1;
-                return *this;
+                size_type count = 0;
+                if (!other.to_size(count)) return to_zero();
+                return shift_right_bits(count);
             }
-            constexpr natural& filp()noexcept {
+            // growable storage has no fixed width, only the limbs in use are flipped
+            HWSHQTB_CONSTEXPR14 natural& filp()noexcept {
                 if (is_NaN() || is_inf()) return *this;
-                for (std::size_t i = 0; i < _length; ++i)
-                    _memory[i] = (~_memory[i]) & lower_half;
-                for (std::size_t i = _length; i < _memory.size(); ++i)
-                    _memory[i] = lower_half;
-                _length = _memory.size();
-                while (_length > 1 && _memory[_length - 1] == 0) --_length;
+                kernel::not_n(_memory.data(), _memory.data(), _length);
+                if HWSHQTB_CONSTEXPR17(!is_growable_storage<container_type>::value) {
+                    for (std::size_t i = _length; i < _memory.size(); ++i)
+                        _memory[i] = limb_max;
+                    _length = _memory.size();
+                }
+                remove_zero();
                 return *this;
             }
-            constexpr natural div(const natural& other)noexcept {
+            // *this becomes the remainder, returns the quotient
+            HWSHQTB_CONSTEXPR14 natural div(const natural& other)noexcept {
                 if (is_NaN() || other.is_NaN() || other.is_zero() || (is_inf() && other.is_inf())) {
                     to_NaN();
                     return NaN();
@@ -349,248 +446,172 @@ namespace hwshqtb {
                 }
                 if (is_zero() || other.is_inf() || operator<(other)) return zero();
                 natural result;
-                result._length = _length - other._length + 1;
-                std::size_t i = _length - other._length + 1;
-                do {
-                    --i;
-                    natural x{_memory, i, _length};
-                    while (x > other) {
-                        x -= other;
-                        ++result._memory[i];
-                    }
-                    if (x == other) ++result._memory[i];
-                    for (std::size_t j = 0; j < x._length; ++j)
-                        _memory[i + j] = x._memory[j];
-                    _length = i + x._length;
-                }
-                while (i > 0);
-                while (_length > 0 && _memory[_length - 1] == 0) --_length;
+                const size_type nq = _length - other._length + 1;
+                result.reserve(nq);
+                divide(other._memory.data(), other._length, result._memory.data());
+                result._length = kernel::normalized_length(result._memory.data(), nq);
                 return result;
             }
-            constexpr natural& operator++()noexcept {
+            // *this = floor(sqrt(*this))
+            HWSHQTB_CONSTEXPR14 natural& isqrt()noexcept {
+                return iroot(2);
+            }
+            // *this = floor(*this^(1 / k)), NaN for k = 0
+            // the root of the leading bits is refined by Newton's iteration, every level doubles the precision
+            // so the top level dominates and a root costs a few divisions of the full size
+            HWSHQTB_CONSTEXPR14 natural& iroot(size_type k)noexcept {
+                if (is_NaN()) return *this;
+                if (k == 0) return to_NaN();
+                if (is_inf() || is_zero() || k == 1) return *this;
+                if (_length == 1) {
+                    _memory[0] = kernel::root_1(_memory[0], k);
+                    return *this;
+                }
+                if HWSHQTB_CONSTEXPR17(!has_special) {
+                    const saturating_type r = saturating().root(k);
+                    assign_limbs(r._memory.data(), r._length);
+                    return *this;
+                }
+                return *this = root(k);
+            }
+            // true when *this = r^k for some k >= 2, 0 and 1 included
+            HWSHQTB_CONSTEXPR14 bool is_perfect_power()const noexcept {
+                if (is_NaN() || is_inf()) return false;
+                if HWSHQTB_CONSTEXPR17(!has_special) return saturating().is_perfect_power();
+                if (_length == 1 && _memory[0] <= 1) return true;
+                // the exponent divides the number of trailing zeros
+                size_type zeros = 0;
+                while (_memory[zeros / type_width] == 0) zeros += type_width;
+                zeros += kernel::count_trailing_zeros(_memory[zeros / type_width]);
+                // only prime exponents are tried, the root shrinks to 1 once k reaches the bit width
+                for (size_type k = 2, bits = bit_width(); k < bits; ++k) {
+                    if (zeros % k != 0 && zeros != 0) continue;
+                    bool prime = true;
+                    for (size_type d = 2; d * d <= k && prime; ++d)
+                        prime = k % d != 0;
+                    if (!prime || !power_residue(k)) continue;
+                    natural r(*this);
+                    if (r.iroot(k).power(k) == *this) return true;
+                }
+                return false;
+            }
+            HWSHQTB_CONSTEXPR14 natural& operator++()noexcept {
                 return operator+=(1);
             }
-            constexpr natural& operator++(int)noexcept {
+            HWSHQTB_CONSTEXPR14 natural operator++(int)noexcept {
                 natural result = *this;
                 operator+=(1);
                 return result;
             }
-            constexpr natural& operator--()noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator--()noexcept {
                 return operator-=(1);
             }
-            constexpr natural& operator--(int)noexcept {
+            HWSHQTB_CONSTEXPR14 natural operator--(int)noexcept {
                 natural result = *this;
                 operator-=(1);
                 return result;
             }
 
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator+=(Integer other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator+=(Integer other)noexcept {
                 if (is_NaN() || is_inf()) return *this;
-                if (is_zero()) return operator=(other);
-                if (other == 0) return *this;
-                if (other < 0) return operator-=(-other);
-                std::common_type_t<value_type, Integer> v = other;
-                value_type carry = 0;
-                for (std::size_t i = 0; i < _length && (carry != 0 || v != 0); ++i) {
-                    carry = (_memory[i] += carry + (v & lower_half)) >> lower_width;
-                    _memory[i] &= lower_half;
-                    v >>= lower_width;
-                }
-                while (_length < _memory.size() && (carry != 0 || v != 0)) {
-                    carry = (_memory[_length] += carry + (v & lower_half)) >> lower_width;
-                    _memory[_length++] &= lower_half;
-                    v >>= lower_width;
-                }
-                if (carry != 0 || v != 0) return to_inf();
-                return *this;
+                value_type limbs[integer_length<Integer>] = {};
+                size_type length = split(other, limbs);
+                return other < 0 ? sub_limbs(limbs, length) : add_limbs(limbs, length);
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator-=(Integer other)noexcept {
-                if (is_NaN() || is_inf() || other == 0) return *this;
-                if (other < 0) return operator+=(-other);
-                if (is_zero()) return to_inf();
-                std::common_type_t<value_type, Integer> v = other;
-                value_type borrow = 0;
-                for (std::size_t i = 0; i < _length && (borrow != 0 || v != 0); ++i) {
-                    value_type sub = v & lower_half;
-                    v >>= lower_width;
-                    if (_memory[i] < borrow + sub) {
-                        _memory[i] += lower_half - borrow - sub;
-                        borrow = 1;
-                    }
-                    else {
-                        _memory[i] -= borrow - sub;
-                        borrow = 0;
-                    }
-                }
-                if (borrow != 0 || v != 0) return to_zero();
-                while (_length > 0 && _memory[_length] == 0) --_length;
-                return *this;
+            HWSHQTB_CONSTEXPR14 natural& operator-=(Integer other)noexcept {
+                if (is_NaN() || is_inf()) return *this;
+                value_type limbs[integer_length<Integer>] = {};
+                size_type length = split(other, limbs);
+                return other < 0 ? add_limbs(limbs, length) : sub_limbs(limbs, length);
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator*=(Integer other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator*=(Integer other)noexcept {
                 if (is_NaN()) return *this;
                 if (other == 0 && is_inf()) return to_NaN();
                 if (is_inf() || is_zero()) return *this;
                 if (other == 0) return to_zero();
-                if (other < 0) return to_inf();
-                std::common_type_t<value_type, Integer> v = other;
-                natural x(*this);
-                to_zero();
-                while (!is_inf() && v != 0) {
-                    natural y(x);
-                    y.multiply_base(v & lower_half);
-                    operator+=(y);
-                    v >>= lower_width;
-                    if (v != 0)
-                        x.shift_left(1);
+                if (other < 0) {
+                    if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                    // the two's complement of other
+                    natural y;
+                    y.assign(other);
+                    return operator*=(y);
                 }
-                return *this;
+                value_type limbs[integer_length<Integer>] = {};
+                return mul_limbs(limbs, split(other, limbs));
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator/=(Integer other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator/=(Integer other)noexcept {
                 if (is_NaN()) return *this;
                 if (other == 0) return to_NaN();
                 if (is_inf() || is_zero()) return *this;
-                if (other < 0) return to_inf();
-                if (operator<(other)) return to_zero();
-                if (other > base) return operator/=(natural(other));
-                std::common_type_t<value_type, Integer> v = other;
-                std::common_type_t<value_type, Integer> remaining = 0;
-                std::size_t i = _length;
-                do {
-                    remaining = remaining * base + _memory[--i];
-                    if (remaining >= v) {
-                        _memory[i] = remaining / v;
-                        remaining %= v;
-                    }
-                    else _memory[i] = 0;
+                if (other < 0) {
+                    if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                    natural y;
+                    y.assign(other);
+                    return operator/=(y);
                 }
-                while (i != 0);
-                while (_length > 1 && _memory[_length - 1] == 0) --_length;
-                return *this;
+                value_type limbs[integer_length<Integer>] = {};
+                size_type length = split(other, limbs);
+                if (kernel::compare(_memory.data(), _length, limbs, length) < 0) return to_zero();
+                return div_limbs(limbs, length);
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator%=(Integer other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator%=(Integer other)noexcept {
                 if (is_NaN()) return *this;
                 if (other == 0 || is_inf()) return to_NaN();
-                if (other < 0) return to_inf();
-                if (is_zero() || operator<(other)) return *this;
-                if (other > base) return operator%=(natural(other));
-                std::common_type_t<value_type, Integer> v = other;
-                std::common_type_t<value_type, Integer> remaining = 0;
-                do remaining = (remaining * base + _memory[--_length]) % v;
-                while (_length != 0);
-                return operator=(remaining);
+                if (other < 0) {
+                    if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                    natural y;
+                    y.assign(other);
+                    return operator%=(y);
+                }
+                if (is_zero()) return *this;
+                value_type limbs[integer_length<Integer>] = {};
+                size_type length = split(other, limbs);
+                if (kernel::compare(_memory.data(), _length, limbs, length) >= 0)
+                    divide(limbs, length, nullptr);
+                return *this;
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator&=(Integer other)noexcept {
-                if (is_NaN()) return *this;
-                if (is_zero()) return *this;
+            HWSHQTB_CONSTEXPR14 natural& operator&=(Integer other)noexcept {
+                if (is_NaN() || is_zero()) return *this;
                 if (other == 0) return to_zero();
                 if (is_inf()) return *this;
-                std::common_type_t<value_type, Integer> v = other;
-                std::size_t i = 0;
-                while (i < _length && v != 0) {
-                    _memory[i++] &= v & lower_half;
-                    v >>= lower_width;
-                }
-                while (_length > 1 && _memory[_length - 1] == 0) --_length;
-                return *this;
+                value_type limbs[integer_length<Integer>] = {};
+                return and_limbs(limbs, split((std::make_unsigned_t<Integer>)other, limbs));
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator|=(Integer other)noexcept {
-                if (is_NaN()) return *this;
-                if (is_zero()) return *this = other;
-                if (other == 0) return *this;
-                if (is_inf()) return *this;
-                std::common_type_t<value_type, Integer> v = other;
-                std::size_t i = 0;
-                while (i < _length && v != 0) {
-                    _memory[i++] |= v & lower_half;
-                    v >>= lower_width;
-                }
-                while (_length < _memory.size() && v != 0) {
-                    _memory[_length++] = v & lower_half;
-                    v >>= lower_width;
-                }
-                return *this;
+            HWSHQTB_CONSTEXPR14 natural& operator|=(Integer other)noexcept {
+                if (is_NaN() || is_inf()) return *this;
+                value_type limbs[integer_length<Integer>] = {};
+                return or_limbs(limbs, split((std::make_unsigned_t<Integer>)other, limbs));
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator^=(Integer other)noexcept {
-                if (is_NaN()) return *this;
-                if (is_zero()) return *this = other;
-                if (other == 0) return *this;
-                if (is_inf()) return *this;
-                std::common_type_t<value_type, Integer> v = other;
-                std::size_t i = 0;
-                while (i < _length && v != 0) {
-                    _memory[i++] ^= v & lower_half;
-                    v >>= lower_width;
-                }
-                while (_length < _memory.size() && v != 0) {
-                    _memory[_length++] = v & lower_half;
-                    v >>= lower_width;
-                }
-                while (_length > 1 && _memory[_length - 1] == 0) --_length;
-                return *this;
+            HWSHQTB_CONSTEXPR14 natural& operator^=(Integer other)noexcept {
+                if (is_NaN() || is_inf()) return *this;
+                value_type limbs[integer_length<Integer>] = {};
+                return xor_limbs(limbs, split((std::make_unsigned_t<Integer>)other, limbs));
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator<<=(Integer other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator<<=(Integer other)noexcept {
                 if (is_NaN()) return *this;
                 if (is_zero() || other == 0 || is_inf()) return *this;
-                if (other < 0) return to_inf();
-                std::common_type_t<value_type, Integer> v = other;
-                value_type remaining = v % lower_width;
-                v /= lower_width;
-                if (v)
-                    shift_left(v);
-                if (remaining) {
-                    std::size_t index = _length - 1;
-                    if ((_memory[index] >> (lower_width - remaining)) && index == _memory.size()) return to_inf();
-                    ++index;
-                    _memory[index] = 0;
-                    do {
-                        --index;
-                        _memory[index + 1] |= (_memory[index] >> (lower_width - remaining));
-                        _memory[index] = (_memory[index] << remaining) & lower_half;
-                    }
-                    while (index > 0);
-                    _length = _memory[_length] ? _length : _length - 1;
-                }
-                return *this;
+                if (other < 0 || (std::make_unsigned_t<Integer>)other > std::numeric_limits<size_type>::max()) return to_inf();
+                return shift_left_bits((size_type)other);
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural& operator>>=(Integer other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural& operator>>=(Integer other)noexcept {
                 if (is_NaN()) return *this;
                 if (is_zero() || other == 0 || is_inf()) return *this;
-                if (other < 0) return to_zero();
-                std::common_type_t<value_type, Integer> v = other;
-                value_type remaining = v % lower_width;
-                v /= lower_width;
-                if (v) {
-                    std::size_t index = 0, index2 = v;
-                    if (v >= _length) return to_zero();
-                    while (index2 != _length)
-                        _memory[index++] = _memory[index2++];
-                    while (index != _length)
-                        _memory[index++] = 0;
-                }
-                if (remaining) {
-                    std::size_t index = 0;
-                    if (_length == 1 && !(_memory[0] >> remaining)) return to_zero();
-                    while (index < _length - v) {
-                        _memory[index] >>= remaining;
-                        _memory[index] |= _memory[index + 1] >> (lower_width - remaining);
-                    }
-                }
-                _length = _memory[_length - v - 1] ? _length - v : _length - v - 1;
-                if (_length == 0) _length = 1;
-                return *this;
+                if (other < 0 || (std::make_unsigned_t<Integer>)other > std::numeric_limits<size_type>::max()) return to_zero();
+                return shift_right_bits((size_type)other);
             }
+            // *this becomes the remainder, returns the quotient
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural div(Integer other)noexcept {
+            HWSHQTB_CONSTEXPR14 natural div(Integer other)noexcept {
                 if (is_NaN() || other == 0) {
                     to_NaN();
                     return NaN();
@@ -599,175 +620,117 @@ namespace hwshqtb {
                     to_NaN();
                     return infinity();
                 }
-                if (is_zero() || operator<(other)) return zero();
-                if (other > base) return div(natural(other));
-                std::common_type_t<value_type, Integer> v = other;
-                std::common_type_t<value_type, Integer> remaining = 0;
-                std::size_t i = _length;
-                do {
-                    remaining = remaining * base + _memory[--i];
-                    if (remaining >= v) {
-                        _memory[i] = remaining / v;
-                        remaining %= v;
+                if (other < 0) {
+                    if HWSHQTB_CONSTEXPR17(!has_special) {
+                        natural y;
+                        y.assign(other);
+                        return div(y);
                     }
-                    else _memory[i] = 0;
+                    to_NaN();
+                    return infinity();
                 }
-                while (i != 0);
-                while (_length > 1 && _memory[_length - 1] == 0) --_length;
-                return natural(remaining);
+                if (is_zero() || operator<(other)) return zero();
+                value_type limbs[integer_length<Integer>] = {};
+                size_type length = split(other, limbs);
+                natural result;
+                const size_type nq = _length - length + 1;
+                result.reserve(nq);
+                divide(limbs, length, result._memory.data());
+                result._length = kernel::normalized_length(result._memory.data(), nq);
+                return result;
             }
 
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
             constexpr explicit operator Integer()const noexcept {
-                Integer result = 0;
-                std::size_t i = _length;
-                do result = result * base + _memory[--i];
-                while (i != 0);
-                return result;
+                using unsigned_type = std::make_unsigned_t<Integer>;
+                unsigned_type result = 0;
+                for (std::size_t i = 0; i < _length && i * type_width < (std::size_t)std::numeric_limits<unsigned_type>::digits; ++i)
+                    result |= (unsigned_type)((unsigned_type)_memory[i] << (i * type_width));
+                return (Integer)result;
             }
 
-            constexpr bool operator==(const natural& other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator==(const natural& other)const noexcept {
                 if (is_NaN() || is_inf() || other.is_NaN() || other.is_inf()) return false;
-                if (_length != other._length) return false;
-                std::size_t i = _length;
-                do {
-                    --i;
-                    if (_memory[i] != other[i]) return false;
-                }
-                while (i > 0);
-                return true;
+                return kernel::compare(_memory.data(), _length, other._memory.data(), other._length) == 0;
             }
-            constexpr bool operator!=(const natural& other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator!=(const natural& other)const noexcept {
                 if (is_NaN() || other.is_NaN()) return false;
                 if (is_inf() || other.is_inf()) return true;
-                if (_length != other._length) return true;
-                std::size_t i = _length;
-                do {
-                    --i;
-                    if (_memory[i] != other[i]) return true;
-                }
-                while (i > 0);
-                return false;
+                return kernel::compare(_memory.data(), _length, other._memory.data(), other._length) != 0;
             }
-            constexpr bool operator<(const natural& other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator<(const natural& other)const noexcept {
                 if (is_NaN() || is_inf() || other.is_NaN() || other.is_inf()) return false;
-                if (_length != other._length) return _length < other._length;
-                std::size_t i = _length;
-                do {
-                    --i;
-                    if (_memory[i] != other[i]) return _memory[i] < other[i];
-                }
-                while (i > 0);
-                return false;
+                return kernel::compare(_memory.data(), _length, other._memory.data(), other._length) < 0;
             }
-            constexpr bool operator<=(const natural& other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator<=(const natural& other)const noexcept {
                 if (is_NaN() || is_inf() || other.is_NaN() || other.is_inf()) return false;
-                if (_length != other._length) return _length < other._length;
-                std::size_t i = _length;
-                do {
-                    --i;
-                    if (_memory[i] != other[i]) return _memory[i] < other[i];
-                }
-                while (i > 0);
-                return true;
+                return kernel::compare(_memory.data(), _length, other._memory.data(), other._length) <= 0;
             }
-            constexpr bool operator>(const natural& other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator>(const natural& other)const noexcept {
                 if (is_NaN() || is_inf() || other.is_NaN() || other.is_inf()) return false;
-                if (_length != other._length) return _length > other._length;
-                std::size_t i = _length;
-                do {
-                    --i;
-                    if (_memory[i] != other[i]) return _memory[i] > other[i];
-                }
-                while (i > 0);
-                return false;
+                return kernel::compare(_memory.data(), _length, other._memory.data(), other._length) > 0;
             }
-            constexpr bool operator>=(const natural& other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator>=(const natural& other)const noexcept {
                 if (is_NaN() || is_inf() || other.is_NaN() || other.is_inf()) return false;
-                if (_length != other._length) return _length > other._length;
-                std::size_t i = _length;
-                do {
-                    --i;
-                    if (_memory[i] != other[i]) return _memory[i] > other[i];
-                }
-                while (i > 0);
-                return true;
+                return kernel::compare(_memory.data(), _length, other._memory.data(), other._length) >= 0;
             }
 
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr bool operator==(Integer other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator==(Integer other)const noexcept {
                 if (is_NaN() || is_inf()) return false;
-                std::common_type_t<value_type, Integer> v = other;
-                std::size_t i = 0;
-                for (; i < _length && v != 0; ++i) {
-                    if (_memory[i] != (v & lower_half)) return false;
-                    v >>= lower_width;
-                }
-                return i == _length && v == 0;
+                return compare_integer(other) == 0;
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr bool operator!=(Integer other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator!=(Integer other)const noexcept {
                 if (is_NaN()) return false;
                 if (is_inf()) return true;
-                std::common_type_t<value_type, Integer> v = other;
-                std::size_t i = 0;
-                for (; i < _length && v != 0; ++i) {
-                    if (_memory[i] != (v & lower_half)) return true;
-                    v >>= lower_width;
-                }
-                return i != _length || v != 0;
+                return compare_integer(other) != 0;
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr bool operator<(Integer other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator<(Integer other)const noexcept {
                 if (is_NaN() || is_inf()) return false;
-                std::common_type_t<value_type, Integer> v = other;
-                value_type state = 2;
-                std::size_t i = 0;
-                for (; i < _length && v != 0; ++i) {
-                    if (_memory[i] != (v & lower_half)) state = _memory[i] < (v & lower_half);
-                    v = v >> lower_width;
-                }
-                if (i == _length && v == 0) return state == 1;
-                return i == _length;
+                return compare_integer(other) < 0;
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr bool operator<=(Integer other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator<=(Integer other)const noexcept {
                 if (is_NaN() || is_inf()) return false;
-                std::common_type_t<value_type, Integer> v = other;
-                value_type state = 2;
-                std::size_t i = 0;
-                for (; i < _length && v != 0; ++i) {
-                    if (_memory[i] != (v & lower_half)) state = _memory[i] < (v & lower_half);
-                    v >>= lower_width;
-                }
-                if (i == _length && v == 0) return state != 0;
-                return i == _length;
+                return compare_integer(other) <= 0;
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr bool operator>(Integer other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator>(Integer other)const noexcept {
                 if (is_NaN() || is_inf()) return false;
-                std::common_type_t<value_type, Integer> v = other;
-                value_type state = 2;
-                std::size_t i = 0;
-                for (; i < _length && v != 0; ++i) {
-                    if (_memory[i] != (v & lower_half)) state = _memory[i] > (v & lower_half);
-                    v >>= lower_width;
-                }
-                if (i == _length && v == 0) return state == 1;
-                return v == 0;
+                return compare_integer(other) > 0;
             }
             template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr bool operator>=(Integer other)const noexcept {
+            HWSHQTB_CONSTEXPR14 bool operator>=(Integer other)const noexcept {
                 if (is_NaN() || is_inf()) return false;
-                std::common_type_t<value_type, Integer> v = other;
-                value_type state = 2;
-                std::size_t i = 0;
-                for (; i < _length && v != 0; ++i) {
-                    if (_memory[i] != (v & lower_half)) state = _memory[i] > (v & lower_half);
-                    v >>= lower_width;
-                }
-                if (i == _length && v == 0) return state != 0;
-                return v == 0;
+                return compare_integer(other) >= 0;
+            }
+
+            HWSHQTB_CONSTEXPR14 bool operator==(limb_view<value_type> other)const noexcept {
+                if (is_NaN() || is_inf()) return false;
+                return compare_limbs(other) == 0;
+            }
+            HWSHQTB_CONSTEXPR14 bool operator!=(limb_view<value_type> other)const noexcept {
+                if (is_NaN()) return false;
+                if (is_inf()) return true;
+                return compare_limbs(other) != 0;
+            }
+            HWSHQTB_CONSTEXPR14 bool operator<(limb_view<value_type> other)const noexcept {
+                if (is_NaN() || is_inf()) return false;
+                return compare_limbs(other) < 0;
+            }
+            HWSHQTB_CONSTEXPR14 bool operator<=(limb_view<value_type> other)const noexcept {
+                if (is_NaN() || is_inf()) return false;
+                return compare_limbs(other) <= 0;
+            }
+            HWSHQTB_CONSTEXPR14 bool operator>(limb_view<value_type> other)const noexcept {
+                if (is_NaN() || is_inf()) return false;
+                return compare_limbs(other) > 0;
+            }
+            HWSHQTB_CONSTEXPR14 bool operator>=(limb_view<value_type> other)const noexcept {
+                if (is_NaN() || is_inf()) return false;
+                return compare_limbs(other) >= 0;
             }
 
             /*template <typename CharT, class Traits = std::char_traits<CharT>>
@@ -788,6 +751,156 @@ namespace hwshqtb {
             constexpr void to_c_str(CharT* pointer, std::size_t N, Traits traits) {
                 return {};
             }*/
+            // locale independent conversion in the manner of std::to_chars, digits of `base` (2 to 36) in lowercase
+            // NaN and infinity are written as "nan" and "inf"
+            friend std::to_chars_result to_chars(char* first, char* last, const natural& x, int base = 10) {
+                if (base < 2 || base > 36) return {last, std::errc::invalid_argument};
+                if (x.is_NaN() || x.is_inf()) {
+                    const char* str = x.is_NaN() ? NaN_str[0] : infinity_str[0];
+                    if (last - first < 3) return {last, std::errc::value_too_large};
+                    for (std::size_t i = 0; i < 3; ++i) *first++ = str[i];
+                    return {first, std::errc()};
+                }
+                scratch_buffer<unsigned char> digits(kernel::digits_bound<value_type>(x._length, base));
+                const std::size_t count = kernel::to_digits<policy_type>(digits.data(), x._memory.data(), x._length, (unsigned)base);
+                if ((std::size_t)(last - first) < count) return {last, std::errc::value_too_large};
+                for (std::size_t i = 0; i < count; ++i)
+                    *first++ = "0123456789abcdefghijklmnopqrstuvwxyz"[digits[i]];
+                return {first, std::errc()};
+            }
+            // locale independent parsing in the manner of std::from_chars, no sign, prefix or whitespace is accepted
+            // "nan" and "inf" (any case) give NaN and infinity, `x` is left untouched unless the result fits
+            friend std::from_chars_result from_chars(const char* first, const char* last, natural& x, int base = 10) {
+                if (base < 2 || base > 36) return {first, std::errc::invalid_argument};
+                for (std::size_t k = 0; k < 2 && has_special; ++k) {
+                    const char* str = k == 0 ? NaN_str[0] : infinity_str[0];
+                    std::size_t i = 0;
+                    while (i < 3 && first + i != last && (first[i] == str[i] || first[i] == str[i] - 'a' + 'A')) ++i;
+                    if (i == 3) {
+                        if (k == 0) x.to_NaN();
+                        else x.to_inf();
+                        return {first + 3, std::errc()};
+                    }
+                }
+                std::vector<unsigned char> digits;
+                const char* iter = first;
+                for (; iter != last; ++iter) {
+                    int digit = *iter >= '0' && *iter <= '9' ? *iter - '0' : *iter >= 'a' && *iter <= 'z' ? *iter - 'a' + 10 : *iter >= 'A' && *iter <= 'Z' ? *iter - 'A' + 10 : base;
+                    if (digit >= base) break;
+                    digits.push_back((unsigned char)digit);
+                }
+                if (digits.empty()) return {first, std::errc::invalid_argument};
+                scratch_buffer<value_type> limbs(kernel::limbs_bound<value_type>(digits.size(), base));
+                natural v;
+                const size_type length = kernel::normalized_length(limbs.data(), kernel::from_digits<policy_type>(limbs.data(), digits.data(), digits.size(), (unsigned)base));
+                if (!v.reserve(length)) return {iter, std::errc::result_out_of_range};
+                v.assign_limbs(limbs.data(), length);
+                x = v;
+                return {iter, std::errc()};
+            }
+            // compact binary record: an unsigned LEB128 header of bytes * 4 + state (0 finite, 1 NaN, 2 infinity),
+            // then the `bytes` significant bytes of the value, least significant first, zero has none
+            // the record does not depend on the byte order or the limb width, a value below 2^248 has a one byte header
+            friend std::size_t binary_size(const natural& x)noexcept {
+                const std::uint64_t header = binary_header(x);
+                std::size_t size = 1 + (std::size_t)header_bytes(header);
+                for (std::uint64_t h = header; h >= 0x80; h >>= 7) ++size;
+                return size;
+            }
+            friend to_binary_result to_binary(unsigned char* first, unsigned char* last, const natural& x)noexcept {
+                if ((std::size_t)(last - first) < binary_size(x)) return {last, std::errc::value_too_large};
+                std::uint64_t header = binary_header(x);
+                const std::size_t bytes = header_bytes(header);
+                for (; header >= 0x80; header >>= 7) *first++ = (unsigned char)(header | 0x80);
+                *first++ = (unsigned char)header;
+                const std::size_t full = bytes / sizeof(value_type);
+                for (std::size_t i = 0; i < full; ++i) {
+                    const value_type limb = x._memory[i];
+                    // a fixed byte pattern, a single store on little endian targets
+                    for (std::size_t k = 0; k < sizeof(value_type); ++k)
+                        *first++ = (unsigned char)(limb >> (k * CHAR_BIT));
+                }
+                for (std::size_t k = 0; k < bytes % sizeof(value_type); ++k)
+                    *first++ = (unsigned char)(x._memory[full] >> (k * CHAR_BIT));
+                return {first, std::errc()};
+            }
+            // reads one record of to_binary, zero bytes on top are accepted
+            // NaN and infinity are out of range without special values, `x` is left untouched unless the result fits
+            friend from_binary_result from_binary(const unsigned char* first, const unsigned char* last, natural& x)noexcept {
+                std::uint64_t header = 0;
+                const unsigned char* iter = first;
+                if (!parse_binary_header(iter, last, header)) return {first, std::errc::invalid_argument};
+                const std::uint64_t state = header & 3, bytes = header_bytes(header);
+                if ((std::uint64_t)(last - iter) < bytes) return {first, std::errc::invalid_argument};
+                if (state != 0) {
+                    if HWSHQTB_CONSTEXPR17(!has_special) return {iter, std::errc::result_out_of_range};
+                    if (state == 1) x.to_NaN();
+                    else x.to_inf();
+                    return {iter, std::errc()};
+                }
+                const unsigned char* end = iter + bytes;
+                std::size_t significant = (std::size_t)bytes;
+                while (significant != 0 && iter[significant - 1] == 0) --significant;
+                const std::size_t length = (significant + sizeof(value_type) - 1) / sizeof(value_type);
+                if (length == 0) {
+                    x.to_zero();
+                    return {end, std::errc()};
+                }
+                if (!x.reserve(length)) return {end, std::errc::result_out_of_range};
+                load_bytes(x._memory.data(), iter, significant);
+                x._length = length;
+                return {end, std::errc()};
+            }
+            // one binary record on a stream, failbit when the record is malformed or does not fit
+            friend std::ostream& write_binary(std::ostream& os, const natural& x) {
+                scratch_buffer<unsigned char> record(binary_size(x));
+                to_binary(record.data(), record.data() + record.size(), x);
+                return os.write(reinterpret_cast<const char*>(record.data()), (std::streamsize)record.size());
+            }
+            friend std::istream& read_binary(std::istream& is, natural& x) {
+                unsigned char header[10];
+                std::size_t size = 0;
+                for (int c; size < sizeof(header); ) {
+                    if ((c = is.get()) == std::istream::traits_type::eof()) return is;
+                    header[size++] = (unsigned char)c;
+                    if (!(c & 0x80)) break;
+                }
+                std::uint64_t value = 0;
+                const unsigned char* iter = header;
+                if (!parse_binary_header(iter, header + size, value)) {
+                    is.setstate(std::ios_base::failbit);
+                    return is;
+                }
+                const std::uint64_t state = value & 3, bytes = header_bytes(value);
+                if (state != 0) {
+                    if HWSHQTB_CONSTEXPR17(!has_special) is.setstate(std::ios_base::failbit);
+                    else if (state == 1) x.to_NaN();
+                    else x.to_inf();
+                    return is;
+                }
+                // the header is not trusted, a record larger than the storage can hold is rejected unread
+                // and memory grows only with the bytes that actually arrive, a chunk at a time
+                if ((bytes + sizeof(value_type) - 1) / sizeof(value_type) > x._memory.max_size()) {
+                    is.setstate(std::ios_base::failbit);
+                    return is;
+                }
+                std::vector<value_type> limbs;
+                std::vector<unsigned char> chunk;
+                for (std::uint64_t done = 0; done < bytes; ) {
+                    const std::size_t count = (std::size_t)std::min<std::uint64_t>(bytes - done, binary_chunk);
+                    chunk.resize(count);
+                    if (!is.read(reinterpret_cast<char*>(chunk.data()), (std::streamsize)count)) return is;
+                    const std::size_t offset = limbs.size();
+                    limbs.resize(offset + (count + sizeof(value_type) - 1) / sizeof(value_type));
+                    load_bytes(limbs.data() + offset, chunk.data(), count);
+                    done += count;
+                }
+                const size_type length = kernel::normalized_length(limbs.data(), limbs.size());
+                if (length == 0) x.to_zero();
+                else if (!x.reserve(length)) is.setstate(std::ios_base::failbit);
+                else x.assign_limbs(limbs.data(), length);
+                return is;
+            }
             template <typename CharT, class Traits>
             friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const natural& x) {
                 //stage 0 check ostream
@@ -807,7 +920,7 @@ namespace hwshqtb {
                     for (std::size_t i = 0; i < 3; ++i)
                         str.push_back(infinity_str[uppercase ? 1 : 0][i]);
                 else if (x.is_zero()) {
-                    if (basefield & std::ios_base::hex) str.insert(str.cend(), {'0', (uppercase ? 'X' : 'x'), '0'});
+                    if ((basefield & std::ios_base::hex) && showbase) str.insert(str.cend(), {'0', (uppercase ? 'X' : 'x'), '0'});
                     else str.push_back('0');
                 }
                 else {
@@ -815,33 +928,25 @@ namespace hwshqtb {
                         std::size_t i = x._length;
                         do {
                             --i;
-                            value_type t = x._memory[i] & lower_half;
-                            for (std::size_t _ = 0; _ < lower_width / 4; ++_, t <<= 4)
-                                str.push_back(hex_str[uppercase ? 1 : 0][(t & ((value_type)0xf << (lower_width - 4))) >> (lower_width - 4)]);
+                            for (std::size_t shift = type_width; shift > 0;) {
+                                shift -= 4;
+                                str.push_back(hex_str[uppercase ? 1 : 0][(x._memory[i] >> shift) & 0xf]);
+                            }
                         }
                         while (i > 0);
                         while (str.front() == '0') str.pop_front();
                         if (showbase) str.insert(str.cbegin(), {'0', (uppercase ? 'X' : 'x')});
                     }
                     else if (basefield & std::ios_base::oct) {
-                        value_type t = 0;
-                        for (std::size_t i = 0; i < x._length; ++i) {
-                            t += (x._memory[i] << (i % 3 * lower_width % 3));
-                            while (t >= 0x8) {
-                                str.push_front((t & 0x7) + '0');
-                                t >>= 3;
-                            }
-                        }
-                        if (t) str.push_front((int)t + '0');
-                        while (str.front() == '0') str.pop_front();
+                        for (size_type bit = 0, width = x.bit_width(); bit < width; bit += 3)
+                            str.push_front((int)x.extract_bits(bit, 3) + '0');
                         if (showbase) str.push_front('0');
                     }
                     else {
-                        natural t = x;
-                        while (!t.is_zero()) {
-                            str.push_front((int)(t % 10) + '0');
-                            t /= 10;
-                        }
+                        scratch_buffer<unsigned char> digits(kernel::digits_bound<value_type>(x._length, 10));
+                        const std::size_t count = kernel::to_digits<policy_type>(digits.data(), x._memory.data(), x._length, 10);
+                        for (std::size_t i = 0; i < count; ++i)
+                            str.push_back((char)(digits[i] + '0'));
                     }
                 }
                 if (showpos && (basefield & std::ios_base::dec) != 0) str.push_front('+');
@@ -978,35 +1083,16 @@ namespace hwshqtb {
                 if (digits.size() == 0)
                     is.setstate(std::ios_base::failbit);
                 natural v;
-                if (basefield == std::ios_base::hex) {
-                    std::size_t o = 0;
-                    for (auto iter = digits.cbegin(); iter != digits.cend(); ++iter) {
-                        v._memory[v._length - 1] |= (*iter << o);
-                        o += 4;
-                        if (o >= lower_width) {
-                            o = 0;
-                            ++v._length;
-                        }
-                    }
+                if (basefield == std::ios_base::hex || basefield == std::ios_base::oct) {
+                    std::size_t step = basefield == std::ios_base::hex ? 4 : 3, position = 0;
+                    for (auto iter = digits.cbegin(); iter != digits.cend() && !v.is_inf(); ++iter, position += step)
+                        v.or_bits(position, (value_type)*iter);
                 }
-                else if (basefield == std::ios_base::oct) {
-                    std::size_t o = 0;
-                    for (auto iter = digits.cbegin(); iter != digits.cend(); ++iter) {
-                        v._memory[v._length - 1] |= (*iter << o);
-                        o += 3;
-                        if (o >= lower_width) {
-                            v._memory[v._length - 1] &= lower_half;
-                            o -= lower_width;
-                            ++v._length;
-                            v._memory[v._length - 1] |= (*iter & (((std::size_t)1 << o) - 1));
-                        }
-                    }
-                }
-                else {
-                    for (auto iter = digits.crbegin(); iter != digits.crend(); ++iter) {
-                        v *= 10;
-                        v += *iter;
-                    }
+                else if (digits.size() != 0) {
+                    scratch_buffer<unsigned char> decimal(digits.size());
+                    std::copy(digits.crbegin(), digits.crend(), decimal.data());
+                    scratch_buffer<value_type> limbs(kernel::limbs_bound<value_type>(decimal.size(), 10));
+                    v.assign_limbs(limbs.data(), kernel::from_digits<policy_type>(limbs.data(), decimal.data(), decimal.size(), 10));
                 }
                 x = v;
                 thousands_seps.push_front(digits.size());
@@ -1036,74 +1122,457 @@ namespace hwshqtb {
                 natural result;
                 return result.to_max();
             }
+            // uniformly random number of at most `length` bits
             template <class URBG, class Uniform_Int_Distribution>
-            static constexpr natural random(std::size_t length, URBG&& urbg, Uniform_Int_Distribution&& rd) {
+            static HWSHQTB_CONSTEXPR14 natural random(std::size_t length, URBG&& urbg, Uniform_Int_Distribution&& rd) {
+                using param_type = typename std::decay_t<Uniform_Int_Distribution>::param_type;
                 natural result;
-                result._length = length / lower_width;
-                for (std::size_t i = 0; i < result._length; ++i)
-                    result._memory[i] = rd(urbg, std::decay_t<Uniform_Int_Distribution>::param_type(0, lower_half));
-                std::size_t remaining = length % lower_width;
+                std::size_t limbs = length / type_width, remaining = length % type_width;
+                if (!result.reserve(limbs + (remaining ? 1 : 0))) return infinity();
+                for (std::size_t i = 0; i < limbs; ++i)
+                    result._memory[i] = rd(urbg, param_type(0, limb_max));
                 if (remaining)
-                    result._memory[result._length++] = rd(urbg, std::decay_t<Uniform_Int_Distribution>::param_type(0, ((value_type)1 << remaining) - 1));
+                    result._memory[limbs++] = rd(urbg, param_type(0, ((value_type)1 << remaining) - 1));
+                result._length = limbs ? limbs : 1;
+                result.remove_zero();
                 return result;
             }
 
         private:
-            template <std::size_t N, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-            constexpr natural(const Integer(&vs)[N], std::size_t l = 0, std::size_t r = N):
-                _length(0), _memory{} {
-                while (l < r)
-                    _memory[_length++] = vs[l++];
+            // magnitude of v in limbs, returns the number of limbs written (at least 1)
+            template <typename Integer>
+            static HWSHQTB_CONSTEXPR14 size_type split(Integer v, value_type* limbs)noexcept {
+                using unsigned_type = std::make_unsigned_t<Integer>;
+                unsigned_type u = v < 0 ? (unsigned_type)0 - (unsigned_type)v : (unsigned_type)v;
+                size_type length = 0;
+                do {
+                    limbs[length++] = (value_type)u;
+                    if HWSHQTB_CONSTEXPR17(std::numeric_limits<unsigned_type>::digits > type_width) u >>= type_width;
+                    else u = 0;
+                }
+                while (u != 0);
+                return length;
+            }
+            template <typename Integer>
+            HWSHQTB_CONSTEXPR14 int compare_integer(Integer other)const noexcept {
+                if (other < 0) return 1;
+                value_type limbs[integer_length<Integer>] = {};
+                size_type length = split(other, limbs);
+                return kernel::compare(_memory.data(), _length, limbs, length);
+            }
+            HWSHQTB_CONSTEXPR14 int compare_limbs(limb_view<value_type> other)const noexcept {
+                other = other.normalized();
+                if (other.empty()) return is_zero() ? 0 : 1;
+                return kernel::compare(_memory.data(), _length, other.data(), other.size());
+            }
+            // header of the binary record of x
+            static std::uint64_t binary_header(const natural& x)noexcept {
+                if (x.is_NaN()) return 1;
+                if (x.is_inf()) return 2;
+                return (std::uint64_t)((x.bit_width() + CHAR_BIT - 1) / CHAR_BIT) << 2;
+            }
+            static constexpr std::uint64_t header_bytes(std::uint64_t header)noexcept {
+                return header >> 2;
+            }
+            // read_binary takes the payload in pieces of this many bytes, a multiple of every limb size
+            static constexpr std::size_t binary_chunk = 65536;
+            // decodes the header at `iter` and moves past it, false when it is truncated, overlong or invalid
+            static bool parse_binary_header(const unsigned char*& iter, const unsigned char* last, std::uint64_t& header)noexcept {
+                header = 0;
+                for (unsigned shift = 0;; shift += 7) {
+                    if (iter == last || shift >= 64 || (shift == 63 && *iter > 1)) return false;
+                    header |= (std::uint64_t)(*iter & 0x7f) << shift;
+                    if (!(*iter++ & 0x80)) break;
+                }
+                const std::uint64_t state = header & 3;
+                return state != 3 && (state == 0 || header_bytes(header) == 0);
+            }
+            // r = the `count` little endian bytes at p, (count + sizeof(value_type) - 1) / sizeof(value_type) limbs
+            static void load_bytes(value_type* r, const unsigned char* p, std::size_t count)noexcept {
+                const std::size_t full = count / sizeof(value_type);
+                for (std::size_t i = 0; i < full; ++i, p += sizeof(value_type)) {
+                    value_type limb = 0;
+                    // a fixed byte pattern, a single load on little endian targets
+                    for (std::size_t k = 0; k < sizeof(value_type); ++k)
+                        limb |= (value_type)((value_type)p[k] << (k * CHAR_BIT));
+                    r[i] = limb;
+                }
+                if (count % sizeof(value_type) == 0) return;
+                value_type limb = 0;
+                for (std::size_t k = 0; k < count % sizeof(value_type); ++k)
+                    limb |= (value_type)((value_type)p[k] << (k * CHAR_BIT));
+                r[full] = limb;
+            }
+            HWSHQTB_CONSTEXPR14 saturating_type saturating()const {
+                saturating_type result;
+                result.assign_limbs(_memory.data(), _length);
+                return result;
+            }
+            // fits the value into `count`, false when it does not
+            HWSHQTB_CONSTEXPR14 bool to_size(size_type& count)const noexcept {
+                if (bit_width() > (size_type)std::numeric_limits<size_type>::digits) return false;
+                count = (size_type)*this;
+                return true;
+            }
+            // *this = *this^k for k >= 1, left to right binary powering
+            HWSHQTB_CONSTEXPR14 natural& power(size_type k)noexcept {
+                const natural base(*this);
+                size_type bit = 1;
+                while (bit <= k / 2) bit <<= 1;
+                for (bit >>= 1; bit != 0; bit >>= 1) {
+                    square();
+                    if (k & bit) *this *= base;
+                }
+                return *this;
+            }
+            // false when a prime q = 1 mod k proves *this is no k-th power, a power has *this^((q - 1) / k) = 0 or 1 mod q
+            // a number that is no k-th power passes each prime with probability about 1 / k
+            HWSHQTB_CONSTEXPR14 bool power_residue(size_type k)const noexcept {
+                size_type tested = 0;
+                for (std::uint64_t q = 2 * (std::uint64_t)k + 1; tested < 4 && q <= limb_max && q < ((std::uint64_t)1 << 32); q += 2 * (std::uint64_t)k) {
+                    bool prime = true;
+                    for (std::uint64_t d = 3; d * d <= q && prime; d += 2)
+                        prime = q % d != 0;
+                    if (!prime) continue;
+                    ++tested;
+                    std::uint64_t base = kernel::mod_1(_memory.data(), _length, (value_type)q), result = 1;
+                    if (base == 0) continue;
+                    for (std::uint64_t e = (q - 1) / k; e != 0; e >>= 1, base = base * base % q)
+                        if (e & 1) result = result * base % q;
+                    if (result != 1) return false;
+                }
+                return true;
+            }
+            // floor(*this^(1 / k)) for finite *this > 0 and k >= 2, not `exact` stops after one Newton step
+            // with a value at or a little above the floor, which is all the next level needs
+            HWSHQTB_CONSTEXPR14 natural root(size_type k, bool exact = true)const noexcept {
+                if (_length == 1) return natural(kernel::root_1(_memory[0], k));
+                const size_type bits = bit_width();
+                if (bits <= k) return natural(1);
+                // the root has at most r bits, `guard` bits of slack keep the first Newton step within one of it
+                const size_type r = (bits + k - 1) / k;
+                size_type guard = 2;
+                for (size_type i = k; i != 0; i >>= 1) ++guard;
+                natural x;
+                if (r <= 2 * guard) {
+                    // few bits, set them one at a time from the top
+                    x.to_zero();
+                    for (size_type i = r; i-- > 0;) {
+                        natural candidate(x);
+                        candidate.or_bits(i, 1);
+                        natural p(candidate);
+                        if (p.power(k) <= *this) x = candidate;
+                    }
+                    return x;
+                }
+                // root(*this >> kh) + 1 scaled by 2^h is above the root by a relative 2^(h - r + 1) at most
+                const size_type h = (r - guard) / 2;
+                natural top(*this);
+                x = top.shift_right_bits(k * h).root(k, false);
+                ++x;
+                x.shift_left_bits(h);
+                // Newton's iteration decreases from above and stops at the floor of the root
+                while (true) {
+                    natural p(x), next(*this);
+                    next /= p.power(k - 1);
+                    p = x;
+                    p *= k - 1;
+                    next += p;
+                    next /= k;
+                    if (next >= x) return x;
+                    if (!exact) return next;
+                    x = next;
+                }
+            }
+            // `count` (< type_width) bits starting at bit `position`
+            HWSHQTB_CONSTEXPR14 value_type extract_bits(size_type position, size_type count)const noexcept {
+                size_type index = position / type_width, offset = position % type_width;
+                value_type v = operator[](index) >> offset;
+                if (offset + count > type_width)
+                    v |= operator[](index + 1) << (type_width - offset);
+                return v & (((value_type)1 << count) - 1);
+            }
+            // *this |= bits << position, bits must be narrower than a limb
+            HWSHQTB_CONSTEXPR14 natural& or_bits(size_type position, value_type bits)noexcept {
+                if (bits == 0) return *this;
+                size_type index = position / type_width, offset = position % type_width;
+                value_type limbs[2] = {(value_type)(bits << offset), offset ? (value_type)(bits >> (type_width - offset)) : (value_type)0};
+                size_type length = kernel::normalized_length(limbs, 2);
+                if (!reserve(index + length)) {
+                    if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                    // bits past the capacity are dropped
+                    if (index >= _memory.size()) return out_of_range();
+                    length = _memory.size() - index;
+                }
+                while (_length < index + length)
+                    _memory[_length++] = 0;
+                for (size_type i = 0; i < length; ++i)
+                    _memory[index + i] |= limbs[i];
+                return *this;
             }
 
-            HWSHQTB_CONSTEXPR14 void remove_zero(std::size_t length) {
-                while (length > 1 && _memory[length - 1] == 0)
-                    --length;
-                return length;
+            HWSHQTB_CONSTEXPR14 void remove_zero()noexcept {
+                _length = kernel::normalized_length(_memory.data(), _length);
+            }
+            // a result past the capacity, infinity or the low limbs already in place when wrapping
+            HWSHQTB_CONSTEXPR14 natural& out_of_range()noexcept {
+                if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                assert(!is_asserting && "hwshqtb::big_number::natural: overflow");
+                remove_zero();
+                return *this;
+            }
+            // *this = y[0, ny) that does not fit the capacity
+            HWSHQTB_CONSTEXPR14 natural& assign_overflow(const value_type* y, size_type ny)noexcept {
+                if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                _length = std::min(ny, _memory.size());
+                for (size_type i = 0; i < _length; ++i)
+                    _memory[i] = y[i];
+                return out_of_range();
+            }
+            // makes room for `count` limbs, false when a fixed size container cannot hold them
+            HWSHQTB_CONSTEXPR14 bool reserve(size_type count)noexcept {
+                return count <= _memory.size() || grow(count, is_growable_storage<container_type>());
+            }
+            constexpr bool grow(size_type, std::false_type)noexcept {
+                return false;
             }
-            HWSHQTB_CONSTEXPR14 void remove_zero() {
-                while (_length > 1 && _memory[_length - 1] == 0)
-                    --_length;
+            // geometric growth keeps repeated carry-outs amortized
+            // a failed allocation is an overflow like any other, reserve() then saturates
+            bool grow(size_type count, std::true_type)noexcept {
+                if (count > _memory.max_size()) return false;
+                try {
+                    _memory.resize(std::max(count, std::min(_memory.size() * 2, _memory.max_size())));
+                    return true;
+                }
+                catch (...) {}
+                // the doubled size may be what failed
+                try {
+                    _memory.resize(count);
+                    return true;
+                }
+                catch (...) {
+                    return false;
+                }
             }
 
-            HWSHQTB_CONSTEXPR14 void shift_left(std::size_t step) {
-                if (_length + step > _memory.size())
-                    to_inf();
+            HWSHQTB_CONSTEXPR14 natural& add_limbs(const value_type* y, size_type ny)noexcept {
+                value_type carry = 0;
+                if (_length >= ny) carry = kernel::add(_memory.data(), _memory.data(), _length, y, ny);
                 else {
-                    std::memmove(_memory + step, _memory, _length * sizeof(value_type));
-                    std::memset(_memory, 0, step * sizeof(value_type));
-                    _length += step;
+                    if (!reserve(ny)) {
+                        if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                        // y modulo the capacity
+                        ny = _memory.size();
+                    }
+                    carry = kernel::add(_memory.data(), y, ny, _memory.data(), _length);
+                    _length = ny;
+                }
+                if (carry) {
+                    if (!reserve(_length + 1)) return out_of_range();
+                    _memory[_length++] = carry;
                 }
+                // the low limbs of a truncated y may be zero
+                if HWSHQTB_CONSTEXPR17(!has_special) remove_zero();
+                return *this;
             }
-            HWSHQTB_CONSTEXPR14 void shift_right(std::size_t step) {
-                if (step >= _length) to_zero();
-                else {
-                    std::memmove(_memory, _memory + step, _length * sizeof(value_type));
-                    _length -= step;
+            HWSHQTB_CONSTEXPR14 natural& sub_limbs(const value_type* y, size_type ny)noexcept {
+                value_type* x = _memory.data();
+                if (kernel::compare(x, _length, y, ny) < 0) {
+                    if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                    // two's complement across the capacity, or across the operands when the storage grows
+                    const size_type n = is_growable_storage<container_type>::value ? std::max(_length, ny) : _memory.size();
+                    reserve(n);
+                    x = _memory.data();
+                    std::memset(x + _length, 0, (n - _length) * sizeof(value_type));
+                    kernel::sub(x, x, n, y, std::min(ny, n));
+                    _length = n;
+                    return out_of_range();
                 }
+                kernel::sub(x, x, _length, y, ny);
+                remove_zero();
+                return *this;
             }
-
-            HWSHQTB_CONSTEXPR14 void base_multiply(value_type v) {
-                value_type carry = 0;
-                for (std::size_t i = 0; i < _length; ++i) {
-                    carry = (_memory[i] = _memory[i] * v + carry) >> lower_width;
-                    _memory[i] &= lower_half;
+            HWSHQTB_CONSTEXPR14 natural& mul_limbs(const value_type* y, size_type ny)noexcept {
+                if (ny == 1) return mul_add_limb(y[0], 0);
+                const size_type nx = _length;
+                const bool square = y == _memory.data();
+                const bool fits = reserve(nx + ny - 1);
+                if HWSHQTB_CONSTEXPR17(has_special)
+                    if (!fits) return to_inf();
+                if (square) y = _memory.data();
+                if (!fits || std::min(nx, ny) >= policy_type::karatsuba_threshold) {
+                    scratch_buffer<value_type> product(nx + ny + kernel::mul_scratch_size(nx, ny));
+                    if (square) kernel::sqr<policy_type>(product.data(), y, nx, product.data() + nx + ny);
+                    else kernel::mul<policy_type>(product.data(), _memory.data(), nx, y, ny, product.data() + nx + ny);
+                    const size_type length = kernel::normalized_length(product.data(), nx + ny);
+                    if (!reserve(length)) return assign_overflow(product.data(), length);
+                    std::memcpy(_memory.data(), product.data(), length * sizeof(value_type));
+                    _length = length;
+                    return *this;
+                }
+                // only the limbs in use are copied, not the whole container
+                scratch_buffer<value_type> copy(nx);
+                std::memcpy(copy.data(), _memory.data(), nx * sizeof(value_type));
+                if (square) y = copy.data();
+                value_type top = kernel::mul_basecase(_memory.data(), copy.data(), nx, y, ny);
+                _length = nx + ny - 1;
+                if (top) {
+                    if (!reserve(_length + 1)) return out_of_range();
+                    _memory[_length++] = top;
+                }
+                remove_zero();
+                return *this;
+            }
+            // *this = x * y written straight into *this, x and y must not alias *this
+            HWSHQTB_CONSTEXPR14 natural& assign_product(const natural& x, const natural& y)noexcept {
+                if (x.is_NaN() || y.is_NaN() || (x.is_zero() && y.is_inf()) || (y.is_zero() && x.is_inf())) return to_NaN();
+                if (x.is_zero() || y.is_zero()) return to_zero();
+                if (x.is_inf() || y.is_inf()) return to_inf();
+                const size_type nx = x._length, ny = y._length;
+                if (std::min(nx, ny) >= policy_type::karatsuba_threshold || !reserve(nx + ny - 1)) {
+                    to_zero();
+                    return addmul(x, y);
+                }
+                const value_type top = nx >= ny ?
+                    kernel::mul_basecase(_memory.data(), x._memory.data(), nx, y._memory.data(), ny) :
+                    kernel::mul_basecase(_memory.data(), y._memory.data(), ny, x._memory.data(), nx);
+                _length = nx + ny - 1;
+                if (top) {
+                    if (!reserve(_length + 1)) return out_of_range();
+                    _memory[_length++] = top;
+                }
+                return *this;
+            }
+            // *this = *this * m + a
+            HWSHQTB_CONSTEXPR14 natural& mul_add_limb(value_type m, value_type a)noexcept {
+                value_type* x = _memory.data();
+                value_type top = kernel::mul_1(x, x, _length, m);
+                top += kernel::add_1(x, x, _length, a);
+                if (top) {
+                    if (!reserve(_length + 1)) return out_of_range();
+                    _memory[_length++] = top;
+                }
+                remove_zero();
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural& div_limbs(const value_type* y, size_type ny)noexcept {
+                const size_type nq = _length - ny + 1;
+                scratch_buffer<value_type> quotient(nq);
+                divide(y, ny, quotient.data());
+                assign_limbs(quotient.data(), nq);
+                return *this;
+            }
+            // *this becomes *this % y, `quotient` (when given) receives _length - ny + 1 limbs
+            // requires *this >= y > 0 with y normalized
+            HWSHQTB_CONSTEXPR14 void divide(const value_type* y, size_type ny, value_type* quotient)noexcept {
+                value_type* x = _memory.data();
+                if (ny == 1) {
+                    x[0] = quotient ? kernel::divrem_1(quotient, x, _length, y[0]) : kernel::mod_1(x, _length, y[0]);
+                    _length = 1;
+                    return;
                 }
-                if (carry != 0) {
-                    if (_length == _memory.size()) to_inf();
-                    else _memory[_length++] = carry;
+                // y may point into *this (x %= x), it is copied into the scratch before x is written
+                scratch_buffer<value_type> scratch(kernel::div_scratch_size(_length, ny));
+                kernel::div<policy_type>(quotient, x, _length, y, ny, scratch.data());
+                _length = kernel::normalized_length(x, ny);
+            }
+            HWSHQTB_CONSTEXPR14 natural& and_limbs(const value_type* y, size_type ny)noexcept {
+                _length = std::min(_length, ny);
+                kernel::and_n(_memory.data(), _memory.data(), y, _length);
+                remove_zero();
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural& or_limbs(const value_type* y, size_type ny)noexcept {
+                ny = kernel::normalized_length(y, ny);
+                if (!reserve(ny)) return to_inf();
+                kernel::or_n(_memory.data(), _memory.data(), y, std::min(_length, ny));
+                for (; _length < ny; ++_length)
+                    _memory[_length] = y[_length];
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural& xor_limbs(const value_type* y, size_type ny)noexcept {
+                ny = kernel::normalized_length(y, ny);
+                if (!reserve(ny)) return to_inf();
+                kernel::xor_n(_memory.data(), _memory.data(), y, std::min(_length, ny));
+                for (; _length < ny; ++_length)
+                    _memory[_length] = y[_length];
+                remove_zero();
+                return *this;
+            }
+            natural& shift_left_bits(size_type count)noexcept {
+                return shift_left_bits(*this, count);
+            }
+            // *this = x << count, x may be *this
+            // whole limbs and the remaining bits move in one pass, a plain memmove when count is a multiple of the width
+            natural& shift_left_bits(const natural& x, size_type count)noexcept {
+                if (x.is_zero() || count == 0) return assign_copy(x);
+                const size_type nx = x._length, limbs = count / type_width, bits = count % type_width;
+                const value_type out = bits ? x._memory[nx - 1] >> (type_width - bits) : 0;
+                if (limbs > _memory.max_size() - nx) return assign_copy(x).shift_out(limbs, bits);
+                const size_type length = nx + limbs + (out ? 1 : 0);
+                if (!reserve(length)) return assign_copy(x).shift_out(limbs, bits);
+                // after reserve, which may move the limbs of *this
+                value_type* r = _memory.data();
+                const value_type* y = x._memory.data();
+                if (bits) {
+                    if (out) r[length - 1] = out;
+                    kernel::lshift(r + limbs, y, nx, bits);
                 }
+                else std::memmove(r + limbs, y, nx * sizeof(value_type));
+                std::memset(r, 0, limbs * sizeof(value_type));
+                _length = length;
+                return *this;
             }
-            HWSHQTB_CONSTEXPR14 value_type base_divide_by(value_type v) {
-                value_type remainder = 0;
-                for (std::size_t i = _length; i > 0; --i) {
-                    remainder = (_memory[i - 1] += remainder << lower_width) % v;
-                    _memory[i - 1] /= v;
+            // *this <<= limbs * type_width + bits past the capacity, infinity or the bits left below the capacity
+            // the shifted value fills the capacity, so only its low capacity - limbs limbs come from *this
+            HWSHQTB_CONSTEXPR14 natural& shift_out(size_type limbs, size_type bits)noexcept {
+                if HWSHQTB_CONSTEXPR17(has_special) return to_inf();
+                const size_type capacity = _memory.size();
+                if (limbs >= capacity) {
+                    to_zero();
+                    return out_of_range();
                 }
+                const size_type n = capacity - limbs;
+                value_type* x = _memory.data();
+                if (bits) kernel::lshift(x + limbs, x, n, bits);
+                else std::memmove(x + limbs, x, n * sizeof(value_type));
+                std::memset(x, 0, limbs * sizeof(value_type));
+                _length = capacity;
+                return out_of_range();
+            }
+            natural& shift_right_bits(size_type count)noexcept {
+                return shift_right_bits(*this, count);
+            }
+            // *this = x >> count, x may be *this
+            natural& shift_right_bits(const natural& x, size_type count)noexcept {
+                if (x.is_zero() || count == 0) return assign_copy(x);
+                const size_type limbs = count / type_width, bits = count % type_width;
+                if (limbs >= x._length) return to_zero();
+                const size_type length = x._length - limbs;
+                // x has at least length limbs, so *this holds them without growing
+                if (!reserve(length)) return to_inf();
+                value_type* r = _memory.data();
+                const value_type* y = x._memory.data() + limbs;
+                if (bits) kernel::rshift(r, y, length, bits);
+                else std::memmove(r, y, length * sizeof(value_type));
+                _length = length;
                 remove_zero();
-                return remainder;
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural& assign_copy(const natural& x)noexcept {
+                if (&x != this) *this = x;
+                return *this;
             }
 
+            template <typename, class, class>
+            friend class natural;
+            template <class Natural>
+            friend class montgomery;
+            template <class Natural>
+            friend class product_expression;
+            template <class Natural>
+            friend class integer;
+
             container_type _memory;
             std::size_t _length;
 
@@ -1113,174 +1582,308 @@ namespace hwshqtb {
             return natural<>(v);
         }
 
-        template <typename T, class Container>
+        template <typename T, class Container, class Policy>
         struct ndiv_t {
-            natural<T, Container> quot, rem;
+            natural<T, Container, Policy> quot, rem;
+        };
+
+        // x * y of two lvalues, evaluated only when it meets its destination
+        // `a * b + c` and `a * b + c * d` accumulate the products into the result without temporaries
+        // it holds references to its operands, so it is usable only as the temporary of the expression that made it
+        // the conversion and every operator take it by rvalue, a named `auto e = a * b;` cannot be converted or combined
+        template <class Natural>
+        class product_expression {
+        public:
+            using natural_type = Natural;
+
+            constexpr product_expression(const natural_type& x, const natural_type& y)noexcept:
+                _x(x), _y(y) {}
+
+            HWSHQTB_CONSTEXPR14 operator natural_type()&& noexcept {
+                return evaluate();
+            }
+
+            friend HWSHQTB_CONSTEXPR14 natural_type operator+(product_expression&& x, const natural_type& y)noexcept {
+                natural_type result = y;
+                x.accumulate(result);
+                return result;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator+(const natural_type& x, product_expression&& y)noexcept {
+                natural_type result = x;
+                y.accumulate(result);
+                return result;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator+(natural_type&& x, product_expression&& y)noexcept {
+                return std::move(y.accumulate(x));
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator+(product_expression&& x, product_expression&& y)noexcept {
+                natural_type result = x.evaluate();
+                y.accumulate(result);
+                return result;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator-(product_expression&& x, const natural_type& y)noexcept {
+                natural_type result = x.evaluate();
+                return result -= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator-(const natural_type& x, product_expression&& y)noexcept {
+                natural_type result = x;
+                return result -= y.evaluate();
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator-(product_expression&& x, product_expression&& y)noexcept {
+                natural_type result = x.evaluate();
+                return result -= y.evaluate();
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator*(product_expression&& x, const natural_type& y)noexcept {
+                natural_type result = x.evaluate();
+                return result *= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator*(const natural_type& x, product_expression&& y)noexcept {
+                natural_type result = y.evaluate();
+                return result *= x;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator*(product_expression&& x, product_expression&& y)noexcept {
+                natural_type result = x.evaluate();
+                return result *= y.evaluate();
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator/(product_expression&& x, const natural_type& y)noexcept {
+                natural_type result = x.evaluate();
+                return result /= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_type operator%(product_expression&& x, const natural_type& y)noexcept {
+                natural_type result = x.evaluate();
+                return result %= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator==(product_expression&& x, const natural_type& y)noexcept {
+                return x.evaluate() == y;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator!=(product_expression&& x, const natural_type& y)noexcept {
+                return x.evaluate() != y;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator<(product_expression&& x, const natural_type& y)noexcept {
+                return x.evaluate() < y;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator<=(product_expression&& x, const natural_type& y)noexcept {
+                return x.evaluate() <= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator>(product_expression&& x, const natural_type& y)noexcept {
+                return x.evaluate() > y;
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator>=(product_expression&& x, const natural_type& y)noexcept {
+                return x.evaluate() >= y;
+            }
+            template <class CharT, class Traits>
+            friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, product_expression&& x) {
+                return os << x.evaluate();
+            }
+
+        private:
+            friend natural_type;
+
+            HWSHQTB_CONSTEXPR14 natural_type evaluate()const noexcept {
+                natural_type result;
+                result.assign_product(_x, _y);
+                return result;
+            }
+            // r += x * y
+            HWSHQTB_CONSTEXPR14 natural_type& accumulate(natural_type& r)const noexcept {
+                return r.addmul(_x, _y);
+            }
+
+            const natural_type& _x;
+            const natural_type& _y;
+
         };
 
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator+(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator+(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result += v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator-(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator+(natural<T, Container, Policy>&& x, const natural<T, Container, Policy>& v)noexcept {
+            return std::move(x += v);
+        }
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator-(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result -= v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator*(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
-            return result *= v;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator-(natural<T, Container, Policy>&& x, const natural<T, Container, Policy>& v)noexcept {
+            return std::move(x -= v);
+        }
+        template <typename T, class Container, class Policy>
+        constexpr product_expression<natural<T, Container, Policy>> operator*(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            return product_expression<natural<T, Container, Policy>>(x, v);
+        }
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator*(natural<T, Container, Policy>&& x, const natural<T, Container, Policy>& v)noexcept {
+            return std::move(x *= v);
+        }
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator*(const natural<T, Container, Policy>& x, natural<T, Container, Policy>&& v)noexcept {
+            return std::move(v *= x);
+        }
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator*(natural<T, Container, Policy>&& x, natural<T, Container, Policy>&& v)noexcept {
+            return std::move(x *= v);
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator/(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator/(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result /= v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator%(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator%(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result %= v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator&(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator&(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result &= v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator|(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator|(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result |= v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator^(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator^(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result ^= v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator<<(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator<<(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result <<= v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator>>(const natural<T, Container>& x, const natural<T, Container>& v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator>>(const natural<T, Container, Policy>& x, const natural<T, Container, Policy>& v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result >>= v;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator~(const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator~(const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = x;
             return result.filp();
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator+(const natural<T, Container>& x)noexcept {
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator+(const natural<T, Container, Policy>& x)noexcept {
             return x;
         }
-        template <typename T, class Container>
-        constexpr natural<T, Container> operator-(const natural<T, Container>& x)noexcept {
-            if (x == 0) return natural<T, Container>::zero();
-            return natural<T, Container>::infinity();
+        template <typename T, class Container, class Policy>
+        constexpr natural<T, Container, Policy> operator-(const natural<T, Container, Policy>& x)noexcept {
+            if HWSHQTB_CONSTEXPR17(!natural<T, Container, Policy>::has_special) {
+                natural<T, Container, Policy> result = natural<T, Container, Policy>::zero();
+                return result -= x;
+            }
+            if (x == 0) return natural<T, Container, Policy>::zero();
+            return natural<T, Container, Policy>::infinity();
         }
 
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator+(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator+(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result += v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator+(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator+(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = x;
             return result += v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator-(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator-(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result -= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator-(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = v;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator-(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = v;
             return result -= x;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator*(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator*(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result *= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator*(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator*(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = x;
             return result *= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator/(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator/(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result /= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator/(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = v;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator/(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = v;
             return result /= x;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator%(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator%(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result %= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator%(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = v;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator%(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = v;
             return result %= x;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator&(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator&(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result &= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator&(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator&(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = x;
             return result &= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator|(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator|(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result |= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator|(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator|(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = x;
             return result |= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator^(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator^(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result = x;
             return result ^= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator^(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator^(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = x;
             return result ^= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator<<(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator<<(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result;
+            if (v >= 0 && (std::make_unsigned_t<Integer>)v <= std::numeric_limits<std::size_t>::max()) return result.shift_left(x, (std::size_t)v);
+            result = x;
             return result <<= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator<<(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = v;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator<<(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = v;
             return result <<= x;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator>>(const natural<T, Container>& x, Integer v)noexcept {
-            natural<T, Container> result = x;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator>>(const natural<T, Container, Policy>& x, Integer v)noexcept {
+            natural<T, Container, Policy> result;
+            if (v >= 0 && (std::make_unsigned_t<Integer>)v <= std::numeric_limits<std::size_t>::max()) return result.shift_right(x, (std::size_t)v);
+            result = x;
             return result >>= v;
         }
-        template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-        constexpr natural<T, Container> operator>>(Integer v, const natural<T, Container>& x)noexcept {
-            natural<T, Container> result = v;
+        template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+        constexpr natural<T, Container, Policy> operator>>(Integer v, const natural<T, Container, Policy>& x)noexcept {
+            natural<T, Container, Policy> result = v;
             return result >>= x;
         }
 
@@ -1288,31 +1891,32 @@ namespace hwshqtb {
 }
 
 namespace std {
-    template <typename T, class Container>
-    constexpr hwshqtb::big_number::natural<T, Container> abs(const hwshqtb::big_number::natural<T, Container>& x)noexcept {
+    template <typename T, class Container, class Policy>
+    constexpr hwshqtb::big_number::natural<T, Container, Policy> abs(const hwshqtb::big_number::natural<T, Container, Policy>& x)noexcept {
         return x;
     }
-    template <typename T, class Container>
-    constexpr hwshqtb::big_number::ndiv_t<T, Container> div(const hwshqtb::big_number::natural<T, Container>& x, const hwshqtb::big_number::natural<T, Container>& y)noexcept {
-        hwshqtb::big_number::ndiv_t<T, Container> result;
+    template <typename T, class Container, class Policy>
+    constexpr hwshqtb::big_number::ndiv_t<T, Container, Policy> div(const hwshqtb::big_number::natural<T, Container, Policy>& x, const hwshqtb::big_number::natural<T, Container, Policy>& y)noexcept {
+        hwshqtb::big_number::ndiv_t<T, Container, Policy> result;
         result.rem = x;
         result.quot = result.rem.div(y);
         return result;
     }
-    template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-    constexpr hwshqtb::big_number::ndiv_t<T, Container> div(const hwshqtb::big_number::natural<T, Container>& x, Integer y)noexcept {
-        hwshqtb::big_number::ndiv_t<T, Container> result;
+    template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+    constexpr hwshqtb::big_number::ndiv_t<T, Container, Policy> div(const hwshqtb::big_number::natural<T, Container, Policy>& x, Integer y)noexcept {
+        hwshqtb::big_number::ndiv_t<T, Container, Policy> result;
         result.rem = x;
         result.quot = result.rem.div(y);
         return result;
     }
-    template <typename T, class Container, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
-    constexpr hwshqtb::big_number::natural<T, Container> pow(const hwshqtb::big_number::natural<T, Container>& x, Integer v) {
-        hwshqtb::big_number::natural<T, Container> result(0), base = x;
+    template <typename T, class Container, class Policy, typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+    constexpr hwshqtb::big_number::natural<T, Container, Policy> pow(const hwshqtb::big_number::natural<T, Container, Policy>& x, Integer v) {
+        hwshqtb::big_number::natural<T, Container, Policy> result(1), base = x;
         while (v) {
             if (v & 1) result *= base;
             v >>= 1;
-            base = base * base;
+            // the last square would be discarded, and could overflow
+            if (v) base.square();
         }
         return result;
     }
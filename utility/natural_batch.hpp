@@ -0,0 +1,282 @@
+#ifndef HWSHQTB__BIG_NUMBER__NATURAL_BATCH_HPP
+#define HWSHQTB__BIG_NUMBER__NATURAL_BATCH_HPP
+
+#include "natural_fixed.hpp"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace hwshqtb {
+    namespace big_number {
+        // size() naturals of `Bits` bits in structure of arrays layout, limb i of number j lives at i * size() + j
+        // every limb position is a contiguous plane, so the plane loops below run one number per vector lane
+        // and compile to straight SIMD code, arithmetic wraps modulo 2^Bits as natural_fixed<Bits, T, false>
+        // 32-bit limbs (the default) let multiplication use the 32 x 32 -> 64 bit vector multiply,
+        // 64-bit limbs vectorize add, sub and the bitwise operations only
+        template <std::size_t Bits, typename T = std::uint32_t>
+        class natural_batch {
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using element_type = natural_fixed<Bits, value_type, false>;
+            using natural_type = natural<value_type, std::vector<value_type>>;
+
+            static constexpr size_type type_width = element_type::type_width;
+            static constexpr size_type limb_count = element_type::limb_count;
+
+        private:
+            using wide_type = typename kernel::limb_traits<value_type>::wide_type;
+
+            // lanes processed together, the per lane carries and the product planes of a block stay in L1
+            static constexpr size_type block = 64;
+
+            // limb i of lane l of a batch, or limb i of one number broadcast to every lane
+            struct planes {
+                const value_type* data;
+                size_type stride;
+
+                constexpr value_type operator()(size_type i, size_type l)const noexcept {
+                    return data[i * stride + l];
+                }
+            };
+            struct broadcast {
+                const value_type* data;
+
+                constexpr value_type operator()(size_type i, size_type)const noexcept {
+                    return data[i];
+                }
+            };
+
+        public:
+            natural_batch() = default;
+            explicit natural_batch(size_type count):
+                _size(count), _limbs(count * limb_count) {}
+            natural_batch(size_type count, const element_type& v):
+                natural_batch(count) {
+                for (size_type i = 0; i < limb_count; ++i)
+                    std::fill_n(plane(i), count, v[i]);
+            }
+            template <class InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+            natural_batch(InputIt first, InputIt last) {
+                const std::vector<element_type> values(first, last);
+                _size = values.size();
+                _limbs.resize(_size * limb_count);
+                for (size_type j = 0; j < _size; ++j)
+                    set(j, values[j]);
+            }
+
+            size_type size()const noexcept {
+                return _size;
+            }
+            bool empty()const noexcept {
+                return _size == 0;
+            }
+            // new numbers are zero
+            void resize(size_type count) {
+                if (count == _size) return;
+                std::vector<value_type> limbs(count * limb_count);
+                const size_type kept = std::min(count, _size);
+                for (size_type i = 0; i < limb_count; ++i)
+                    std::copy_n(plane(i), kept, limbs.data() + i * count);
+                _limbs.swap(limbs);
+                _size = count;
+            }
+
+            // the `index`-th number, gathered from the planes
+            element_type operator[](size_type index)const noexcept {
+                element_type result;
+                value_type limbs[limb_count];
+                for (size_type i = 0; i < limb_count; ++i)
+                    limbs[i] = _limbs[i * _size + index];
+                return result.assign_limbs(limbs, limb_count);
+            }
+            void set(size_type index, const element_type& v)noexcept {
+                for (size_type i = 0; i < limb_count; ++i)
+                    _limbs[i * _size + index] = v[i];
+            }
+            // limb i of every number, size() limbs
+            value_type* plane(size_type i)noexcept {
+                return _limbs.data() + i * _size;
+            }
+            const value_type* plane(size_type i)const noexcept {
+                return _limbs.data() + i * _size;
+            }
+
+            // both batches must have the same size
+            natural_batch& operator+=(const natural_batch& other)noexcept {
+                assert(_size == other._size);
+                add(planes{_limbs.data(), _size}, planes{other._limbs.data(), _size});
+                return *this;
+            }
+            natural_batch& operator+=(const element_type& other)noexcept {
+                add(planes{_limbs.data(), _size}, broadcast{other.memory().data()});
+                return *this;
+            }
+            natural_batch& operator-=(const natural_batch& other)noexcept {
+                assert(_size == other._size);
+                sub(planes{_limbs.data(), _size}, planes{other._limbs.data(), _size});
+                return *this;
+            }
+            natural_batch& operator-=(const element_type& other)noexcept {
+                sub(planes{_limbs.data(), _size}, broadcast{other.memory().data()});
+                return *this;
+            }
+            natural_batch& operator*=(const natural_batch& other) {
+                assert(_size == other._size);
+                mul(planes{_limbs.data(), _size}, planes{other._limbs.data(), _size});
+                return *this;
+            }
+            natural_batch& operator*=(const element_type& other) {
+                mul(planes{_limbs.data(), _size}, broadcast{other.memory().data()});
+                return *this;
+            }
+            // one pass, the multiplier stays in a register
+            natural_batch& operator*=(value_type m)noexcept {
+                for (size_type l0 = 0; l0 < _size; l0 += block) {
+                    const size_type n = std::min(block, _size - l0);
+                    value_type carry[block] = {};
+                    for (size_type i = 0; i < limb_count; ++i) {
+                        value_type* r = plane(i) + l0;
+                        for (size_type l = 0; l < n; ++l) {
+                            const wide_type w = (wide_type)r[l] * m + carry[l];
+                            r[l] = (value_type)w;
+                            carry[l] = (value_type)(w >> type_width);
+                        }
+                    }
+                }
+                return *this;
+            }
+            natural_batch& operator&=(const natural_batch& other)noexcept {
+                assert(_size == other._size);
+                for (size_type k = 0; k < _limbs.size(); ++k) _limbs[k] &= other._limbs[k];
+                return *this;
+            }
+            natural_batch& operator|=(const natural_batch& other)noexcept {
+                assert(_size == other._size);
+                for (size_type k = 0; k < _limbs.size(); ++k) _limbs[k] |= other._limbs[k];
+                return *this;
+            }
+            natural_batch& operator^=(const natural_batch& other)noexcept {
+                assert(_size == other._size);
+                for (size_type k = 0; k < _limbs.size(); ++k) _limbs[k] ^= other._limbs[k];
+                return *this;
+            }
+
+            friend natural_batch operator+(natural_batch x, const natural_batch& y) {
+                return x += y;
+            }
+            friend natural_batch operator+(natural_batch x, const element_type& y) {
+                return x += y;
+            }
+            friend natural_batch operator-(natural_batch x, const natural_batch& y) {
+                return x -= y;
+            }
+            friend natural_batch operator-(natural_batch x, const element_type& y) {
+                return x -= y;
+            }
+            friend natural_batch operator*(natural_batch x, const natural_batch& y) {
+                return x *= y;
+            }
+            friend natural_batch operator*(natural_batch x, const element_type& y) {
+                return x *= y;
+            }
+            friend natural_batch operator*(natural_batch x, value_type y) {
+                return x *= y;
+            }
+            friend natural_batch operator&(natural_batch x, const natural_batch& y) {
+                return x &= y;
+            }
+            friend natural_batch operator|(natural_batch x, const natural_batch& y) {
+                return x |= y;
+            }
+            friend natural_batch operator^(natural_batch x, const natural_batch& y) {
+                return x ^= y;
+            }
+
+            // exact sum of all numbers, every plane is summed in double limbs before the planes are combined
+            natural_type sum()const {
+                // the sum stays below 2^Bits * size()
+                std::vector<value_type> limbs(limb_count + 1 + (std::numeric_limits<size_type>::digits + type_width - 1) / type_width);
+                // a double limb holds the sum of 2^width limbs
+                size_type chunk = _size;
+                if HWSHQTB_CONSTEXPR17(type_width < (size_type)std::numeric_limits<size_type>::digits)
+                    chunk = std::min(_size, (size_type)1 << (type_width % std::numeric_limits<size_type>::digits));
+                for (size_type i = 0; i < limb_count; ++i) {
+                    const value_type* x = plane(i);
+                    for (size_type l0 = 0; l0 < _size; l0 += chunk) {
+                        const size_type n = std::min(chunk, _size - l0);
+                        wide_type partial = 0;
+                        for (size_type l = 0; l < n; ++l) partial += x[l0 + l];
+                        const value_type part[2] = {(value_type)partial, (value_type)(partial >> type_width)};
+                        kernel::add(limbs.data() + i, limbs.data() + i, limbs.size() - i, part, 2);
+                    }
+                }
+                natural_type result;
+                result.assign_limbs(limbs.data(), limbs.size());
+                return result;
+            }
+
+        private:
+            // *this = x + y over every lane, x and y may be *this
+            template <class X, class Y>
+            void add(X x, Y y)noexcept {
+                for (size_type l0 = 0; l0 < _size; l0 += block) {
+                    const size_type n = std::min(block, _size - l0);
+                    value_type carry[block] = {};
+                    for (size_type i = 0; i < limb_count; ++i) {
+                        value_type* r = plane(i) + l0;
+                        for (size_type l = 0; l < n; ++l) {
+                            const value_type a = x(i, l0 + l), s = a + y(i, l0 + l), t = s + carry[l];
+                            carry[l] = (value_type)((s < a) | (t < s));
+                            r[l] = t;
+                        }
+                    }
+                }
+            }
+            template <class X, class Y>
+            void sub(X x, Y y)noexcept {
+                for (size_type l0 = 0; l0 < _size; l0 += block) {
+                    const size_type n = std::min(block, _size - l0);
+                    value_type borrow[block] = {};
+                    for (size_type i = 0; i < limb_count; ++i) {
+                        value_type* r = plane(i) + l0;
+                        for (size_type l = 0; l < n; ++l) {
+                            const value_type a = x(i, l0 + l), d = a - y(i, l0 + l), t = d - borrow[l];
+                            borrow[l] = (value_type)((d > a) | (t > d));
+                            r[l] = t;
+                        }
+                    }
+                }
+            }
+            // *this = x * y mod 2^Bits, row k adds x * y[k] into the product planes of a block of lanes
+            // only the partial products below 2^Bits are formed
+            template <class X, class Y>
+            void mul(X x, Y y) {
+                std::vector<value_type> product(limb_count * block);
+                for (size_type l0 = 0; l0 < _size; l0 += block) {
+                    const size_type n = std::min(block, _size - l0);
+                    std::fill(product.begin(), product.end(), (value_type)0);
+                    for (size_type k = 0; k < limb_count; ++k) {
+                        value_type carry[block] = {};
+                        for (size_type j = 0; j + k < limb_count; ++j) {
+                            value_type* r = product.data() + (k + j) * block;
+                            for (size_type l = 0; l < n; ++l) {
+                                const wide_type w = (wide_type)x(j, l0 + l) * y(k, l0 + l) + r[l] + carry[l];
+                                r[l] = (value_type)w;
+                                carry[l] = (value_type)(w >> type_width);
+                            }
+                        }
+                    }
+                    for (size_type i = 0; i < limb_count; ++i)
+                        std::copy_n(product.data() + i * block, n, plane(i) + l0);
+                }
+            }
+
+            size_type _size = 0;
+            std::vector<value_type> _limbs;
+
+        };
+    }
+}
+
+#endif
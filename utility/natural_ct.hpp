@@ -0,0 +1,444 @@
+#ifndef HWSHQTB__BIG_NUMBER__NATURAL_CT_HPP
+#define HWSHQTB__BIG_NUMBER__NATURAL_CT_HPP
+
+#include "natural_fixed.hpp"
+#include "modular.hpp"
+
+namespace hwshqtb {
+    namespace big_number {
+        namespace kernel {
+            // hides x from the optimizer, so a mask built from secret bits is not turned back into a branch
+            template <typename T>
+            inline T value_barrier(T x)noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+                __asm__("" : "+r"(x));
+                return x;
+#else
+                volatile T v = x;
+                return v;
+#endif
+            }
+            // all ones for choice 1, zero for choice 0
+            template <typename T>
+            inline T ct_mask(T choice)noexcept {
+                return value_barrier((T)((T)0 - choice));
+            }
+            // 1 for x == 0, 0 otherwise
+            template <typename T>
+            inline T ct_is_zero(T x)noexcept {
+                return (T)((T)((x | (T)((T)0 - x)) >> (limb_traits<T>::width - 1)) ^ 1);
+            }
+            // choice ? x : y
+            template <typename T>
+            inline T ct_select(T choice, T x, T y)noexcept {
+                const T mask = ct_mask(choice);
+                return (T)((x & mask) | (y & (T)~mask));
+            }
+        }
+
+        // natural of exactly `Bits` bits whose running time depends on `Bits` only, never on the value
+        // no operation branches on or indexes memory by a limb, arithmetic wraps modulo 2^Bits,
+        // conditions come as a value_type choice of 0 or 1 for ct_select instead of a bool to branch on
+        // shift counts, loop bounds and the integer constants given to the constructor are public
+        // division and text conversion are not constant time and go through natural_fixed
+        template <std::size_t Bits, typename T = std::size_t>
+        class natural_ct {
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+
+            static constexpr size_type type_width = kernel::limb_traits<value_type>::width;
+            static constexpr size_type limb_count = Bits / type_width;
+
+            static_assert(Bits != 0 && Bits % type_width == 0, "Bits must be a positive multiple of the limb width");
+
+            using container_type = std::array<value_type, limb_count>;
+            using fixed_type = natural_fixed<Bits, value_type, false>;
+
+            natural_ct()noexcept:
+                _limbs() {}
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            natural_ct(Integer v)noexcept:
+                _limbs() {
+                assign(v);
+            }
+            explicit natural_ct(const fixed_type& x)noexcept:
+                _limbs(x.memory()) {}
+
+            // negative values wrap around modulo 2^Bits
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            void assign(Integer v)noexcept {
+                _limbs = fixed_type(v).memory();
+            }
+            // *this = y[0, ny) modulo 2^Bits, least significant limb first, ny is public
+            natural_ct& assign_limbs(const value_type* y, size_type ny)noexcept {
+                _limbs = container_type();
+                for (size_type i = 0; i < ny && i < limb_count; ++i)
+                    _limbs[i] = y[i];
+                return *this;
+            }
+
+            value_type operator[](std::size_t index)const noexcept {
+                return _limbs[index];
+            }
+            const container_type& memory()const noexcept {
+                return _limbs;
+            }
+
+            // overwrites every limb, so that key material does not outlive the object in memory
+            void wipe()noexcept {
+                volatile value_type* limbs = _limbs.data();
+                for (size_type i = 0; i < limb_count; ++i) limbs[i] = 0;
+            }
+
+            natural_ct& operator+=(const natural_ct& other)noexcept {
+                add_n(_limbs, _limbs, other._limbs);
+                return *this;
+            }
+            natural_ct& operator-=(const natural_ct& other)noexcept {
+                sub_n(_limbs, _limbs, other._limbs);
+                return *this;
+            }
+            natural_ct& operator*=(const natural_ct& other)noexcept {
+                mul_n(_limbs, _limbs, other._limbs);
+                return *this;
+            }
+            natural_ct& square()noexcept {
+                return operator*=(*this);
+            }
+            natural_ct& operator&=(const natural_ct& other)noexcept {
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] &= other._limbs[i];
+                });
+                return *this;
+            }
+            natural_ct& operator|=(const natural_ct& other)noexcept {
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] |= other._limbs[i];
+                });
+                return *this;
+            }
+            natural_ct& operator^=(const natural_ct& other)noexcept {
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] ^= other._limbs[i];
+                });
+                return *this;
+            }
+            natural_ct& flip()noexcept {
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] = ~_limbs[i];
+                });
+                return *this;
+            }
+            // `count` is public
+            natural_ct& operator<<=(size_type count)noexcept {
+                _limbs = (fixed() <<= count).memory();
+                return *this;
+            }
+            natural_ct& operator>>=(size_type count)noexcept {
+                _limbs = (fixed() >>= count).memory();
+                return *this;
+            }
+
+            friend natural_ct operator+(natural_ct x, const natural_ct& y)noexcept {
+                return x += y;
+            }
+            friend natural_ct operator-(natural_ct x, const natural_ct& y)noexcept {
+                return x -= y;
+            }
+            friend natural_ct operator*(natural_ct x, const natural_ct& y)noexcept {
+                return x *= y;
+            }
+            friend natural_ct operator&(natural_ct x, const natural_ct& y)noexcept {
+                return x &= y;
+            }
+            friend natural_ct operator|(natural_ct x, const natural_ct& y)noexcept {
+                return x |= y;
+            }
+            friend natural_ct operator^(natural_ct x, const natural_ct& y)noexcept {
+                return x ^= y;
+            }
+            friend natural_ct operator~(natural_ct x)noexcept {
+                return x.flip();
+            }
+            friend natural_ct operator<<(natural_ct x, size_type count)noexcept {
+                return x <<= count;
+            }
+            friend natural_ct operator>>(natural_ct x, size_type count)noexcept {
+                return x >>= count;
+            }
+
+            // choices of 0 or 1, every limb is read whatever the values
+            friend value_type ct_is_zero(const natural_ct& x)noexcept {
+                value_type bits = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    bits |= x._limbs[i];
+                });
+                return kernel::ct_is_zero(bits);
+            }
+            friend value_type ct_equal(const natural_ct& x, const natural_ct& y)noexcept {
+                value_type difference = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    difference |= x._limbs[i] ^ y._limbs[i];
+                });
+                return kernel::ct_is_zero(difference);
+            }
+            // the borrow of x - y
+            friend value_type ct_less(const natural_ct& x, const natural_ct& y)noexcept {
+                container_type difference;
+                return sub_n(difference, x._limbs, y._limbs);
+            }
+            // choice ? x : y
+            friend natural_ct ct_select(value_type choice, const natural_ct& x, const natural_ct& y)noexcept {
+                natural_ct result;
+                select_n(result._limbs, choice, x._limbs, y._limbs);
+                return result;
+            }
+            // exchanges x and y when choice is 1, as a Montgomery ladder step needs
+            friend void ct_swap(value_type choice, natural_ct& x, natural_ct& y)noexcept {
+                const value_type mask = kernel::ct_mask(choice);
+                kernel::unroll<limb_count>([&](auto i) {
+                    const value_type t = (x._limbs[i] ^ y._limbs[i]) & mask;
+                    x._limbs[i] ^= t;
+                    y._limbs[i] ^= t;
+                });
+            }
+            // *this = other when choice is 1
+            natural_ct& assign_if(value_type choice, const natural_ct& other)noexcept {
+                select_n(_limbs, choice, other._limbs, _limbs);
+                return *this;
+            }
+
+            // the comparison itself is constant time, branching on the bool is up to the caller
+            friend bool operator==(const natural_ct& x, const natural_ct& y)noexcept {
+                return ct_equal(x, y) != 0;
+            }
+            friend bool operator!=(const natural_ct& x, const natural_ct& y)noexcept {
+                return ct_equal(x, y) == 0;
+            }
+            friend bool operator<(const natural_ct& x, const natural_ct& y)noexcept {
+                return ct_less(x, y) != 0;
+            }
+            friend bool operator<=(const natural_ct& x, const natural_ct& y)noexcept {
+                return ct_less(y, x) == 0;
+            }
+            friend bool operator>(const natural_ct& x, const natural_ct& y)noexcept {
+                return ct_less(y, x) != 0;
+            }
+            friend bool operator>=(const natural_ct& x, const natural_ct& y)noexcept {
+                return ct_less(x, y) == 0;
+            }
+
+            explicit operator fixed_type()const noexcept {
+                return fixed();
+            }
+            // the low bits, as for natural
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            explicit operator Integer()const noexcept {
+                return (Integer)fixed();
+            }
+
+            // leaves the constant time domain, for public values and debugging
+            template <class CharT, class Traits>
+            friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const natural_ct& x) {
+                return os << x.fixed();
+            }
+
+        private:
+            template <std::size_t, typename>
+            friend class montgomery_ct;
+
+            fixed_type fixed()const noexcept {
+                fixed_type result;
+                return result.assign_limbs(_limbs.data(), limb_count);
+            }
+
+            // r = x + y, returns the carry-out
+            static value_type add_n(container_type& r, const container_type& x, const container_type& y)noexcept {
+                value_type carry = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    r[i] = kernel::add_carry(x[i], y[i], carry);
+                });
+                return carry;
+            }
+            // r = x - y, returns the borrow-out
+            static value_type sub_n(container_type& r, const container_type& x, const container_type& y)noexcept {
+                value_type borrow = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    r[i] = kernel::sub_borrow(x[i], y[i], borrow);
+                });
+                return borrow;
+            }
+            // r = choice ? x : y, r may alias x or y
+            static void select_n(container_type& r, value_type choice, const container_type& x, const container_type& y)noexcept {
+                const value_type mask = kernel::ct_mask(choice);
+                kernel::unroll<limb_count>([&](auto i) {
+                    r[i] = (value_type)((x[i] & mask) | (y[i] & (value_type)~mask));
+                });
+            }
+            // r = x * y mod 2^Bits, every row is unrolled and the row loop is not,
+            // so 2048 and 4096-bit operands keep a compact body, r may alias x or y
+            static void mul_n(container_type& r, const container_type& x, const container_type& y)noexcept {
+                container_type product = {};
+                for (size_type k = 0; k < limb_count; ++k) {
+                    value_type carry = 0;
+                    const value_type m = y[k];
+                    kernel::unroll<limb_count>([&](auto j) {
+                        if (j + k < limb_count) product[j + k] = kernel::mul_add(x[j], m, product[j + k], carry);
+                    });
+                }
+                r = product;
+            }
+
+            container_type _limbs;
+
+        };
+
+        // Montgomery arithmetic modulo an odd public modulus m < 2^Bits in constant time,
+        // for modular exponentiation on secret values such as signing keys
+        // mul and sqr work in Montgomery form x R mod m with R = 2^Bits, mul_mod and pow_mod take and give plain residues
+        // the setup reads the modulus with branches, so only the modulus must be public
+        template <std::size_t Bits, typename T = std::size_t>
+        class montgomery_ct {
+        public:
+            using natural_type = natural_ct<Bits, T>;
+            using value_type = T;
+            using size_type = std::size_t;
+
+            static constexpr size_type limb_count = natural_type::limb_count;
+
+        private:
+            using container_type = typename natural_type::container_type;
+
+            // pow_mod scans the exponent in windows of this many bits, a table of 2^window powers is read in full each time
+            static constexpr size_type window = 4;
+
+        public:
+            // `modulus` must be odd and greater than 1
+            explicit montgomery_ct(const natural_type& modulus)noexcept:
+                _m(modulus), _inverse(kernel::negative_inverse(modulus[0])) {
+                assert((modulus[0] & 1) && ct_less(natural_type(1), modulus) && "hwshqtb::big_number::montgomery_ct: even modulus");
+                // R mod m and R^2 mod m by doubling 1, add_mod needs its operands below m
+                natural_type x = 1;
+                for (size_type i = 0; i < Bits; ++i) x = add(x, x);
+                _one = x;
+                for (size_type i = 0; i < Bits; ++i) x = add(x, x);
+                _r2 = x;
+            }
+
+            const natural_type& modulus()const noexcept {
+                return _m;
+            }
+            // R mod m, 1 in Montgomery form
+            const natural_type& one()const noexcept {
+                return _one;
+            }
+
+            // x R mod m for any x below 2^Bits
+            natural_type to_montgomery(const natural_type& x)const noexcept {
+                return mul(x, _r2);
+            }
+            // x / R mod m
+            natural_type from_montgomery(const natural_type& x)const noexcept {
+                return mul(x, natural_type(1));
+            }
+
+            // a + b mod m for a, b < m, in either form
+            natural_type add(const natural_type& a, const natural_type& b)const noexcept {
+                natural_type sum, difference;
+                const value_type carry = natural_type::add_n(sum._limbs, a._limbs, b._limbs);
+                const value_type borrow = natural_type::sub_n(difference._limbs, sum._limbs, _m._limbs);
+                natural_type::select_n(sum._limbs, carry | (value_type)(borrow ^ 1), difference._limbs, sum._limbs);
+                return sum;
+            }
+            // a - b mod m for a, b < m, in either form
+            natural_type sub(const natural_type& a, const natural_type& b)const noexcept {
+                natural_type difference, corrected;
+                const value_type borrow = natural_type::sub_n(difference._limbs, a._limbs, b._limbs);
+                natural_type::add_n(corrected._limbs, difference._limbs, _m._limbs);
+                natural_type::select_n(difference._limbs, borrow, corrected._limbs, difference._limbs);
+                return difference;
+            }
+            // a b / R mod m for a b < m R, e.g. both below m
+            natural_type mul(const natural_type& a, const natural_type& b)const noexcept {
+                natural_type result;
+                mul_n(result._limbs, a._limbs, b._limbs);
+                return result;
+            }
+            natural_type sqr(const natural_type& a)const noexcept {
+                return mul(a, a);
+            }
+
+            // a b mod m for plain residues below m
+            natural_type mul_mod(const natural_type& a, const natural_type& b)const noexcept {
+                return mul(mul(a, b), _r2);
+            }
+            // base^exponent mod m, base below 2^Bits, the time depends on Bits and EBits only
+            // fixed windows, every window squares `window` times, multiplies once and reads the whole table
+            template <std::size_t EBits>
+            natural_type pow_mod(const natural_type& base, const natural_ct<EBits, value_type>& exponent)const noexcept {
+                static_assert(natural_ct<EBits, value_type>::type_width % window == 0, "");
+                constexpr size_type type_width = natural_type::type_width;
+                constexpr size_type table_size = (size_type)1 << window;
+                natural_type table[table_size];
+                table[0] = _one;
+                table[1] = to_montgomery(base);
+                for (size_type k = 2; k < table_size; ++k)
+                    table[k] = mul(table[k - 1], table[1]);
+                natural_type result = _one;
+                for (size_type i = EBits; i > 0;) {
+                    i -= window;
+                    for (size_type j = 0; j < window; ++j)
+                        result = sqr(result);
+                    const value_type digit = (value_type)(exponent[i / type_width] >> (i % type_width)) & (value_type)(table_size - 1);
+                    natural_type factor;
+                    for (size_type k = 0; k < table_size; ++k)
+                        factor.assign_if(kernel::ct_is_zero((value_type)(digit ^ (value_type)k)), table[k]);
+                    result = mul(result, factor);
+                }
+                for (natural_type& entry : table) entry.wipe();
+                return from_montgomery(result);
+            }
+
+        private:
+            // coarsely integrated operand scanning, t = (t + a b[i] + q m) / 2^width row by row
+            // t stays below 2m, so one masked subtraction of m ends it
+            void mul_n(container_type& r, const container_type& a, const container_type& b)const noexcept {
+                value_type t[limb_count + 2] = {};
+                for (size_type i = 0; i < limb_count; ++i) {
+                    value_type carry = 0;
+                    const value_type bi = b[i];
+                    kernel::unroll<limb_count>([&](auto j) {
+                        t[j] = kernel::mul_add(a[j], bi, t[j], carry);
+                    });
+                    value_type top = 0;
+                    t[limb_count] = kernel::add_carry(t[limb_count], carry, top);
+                    t[limb_count + 1] = top;
+                    // q makes the low limb vanish
+                    const value_type q = (value_type)(t[0] * _inverse);
+                    carry = 0;
+                    kernel::mul_add(q, _m._limbs[0], t[0], carry);
+                    kernel::unroll<limb_count - 1>([&](auto j) {
+                        t[j] = kernel::mul_add(q, _m._limbs[j + 1], t[j + 1], carry);
+                    });
+                    top = 0;
+                    t[limb_count - 1] = kernel::add_carry(t[limb_count], carry, top);
+                    t[limb_count] = t[limb_count + 1] + top;
+                }
+                container_type low, difference;
+                kernel::unroll<limb_count>([&](auto j) {
+                    low[j] = t[j];
+                });
+                const value_type borrow = natural_type::sub_n(difference, low, _m._limbs);
+                natural_type::select_n(r, t[limb_count] | (value_type)(borrow ^ 1), difference, low);
+            }
+
+            natural_type _m;
+            value_type _inverse;
+            natural_type _one, _r2;
+
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,641 @@
+#ifndef HWSHQTB__BIG_NUMBER__NATURAL_FIXED_HPP
+#define HWSHQTB__BIG_NUMBER__NATURAL_FIXED_HPP
+
+#include "natural.hpp"
+#include <cctype>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace hwshqtb {
+    namespace big_number {
+        namespace kernel {
+            // f(std::integral_constant<std::size_t, I>()) for I = 0, ..., N - 1, expanded at compile time
+            template <class F, std::size_t... I>
+            HWSHQTB_CONSTEXPR14 void unroll(F&& f, std::index_sequence<I...>)noexcept {
+                (f(std::integral_constant<std::size_t, I>()), ...);
+            }
+            template <std::size_t N, class F>
+            HWSHQTB_CONSTEXPR14 void unroll(F&& f)noexcept {
+                unroll(f, std::make_index_sequence<N>());
+            }
+
+            // NaN and infinity flag of natural_fixed, empty when the caller opts out of special values
+            template <bool Special>
+            struct fixed_state {
+                unsigned char _state = 0;
+            };
+            template <>
+            struct fixed_state<false> {};
+        }
+
+        // natural of exactly `Bits` bits in a std::array, every limb loop is unrolled at compile time
+        // so that 128 to 512 bit values stay in registers and need no length bookkeeping
+        // with `Special` NaN and infinity follow the tables of natural and overflow gives infinity,
+        // without it no state is stored and arithmetic wraps modulo 2^Bits like the built-in unsigned types
+        template <std::size_t Bits, typename T = std::size_t, bool Special = true>
+        class natural_fixed: private kernel::fixed_state<Special> {
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+
+            static constexpr size_type type_width = kernel::limb_traits<value_type>::width;
+            static constexpr size_type limb_count = Bits / type_width;
+            static constexpr bool has_special = Special;
+
+            static_assert(Bits != 0 && Bits % type_width == 0, "Bits must be a positive multiple of the limb width");
+
+            using container_type = std::array<value_type, limb_count>;
+            using natural_type = natural<value_type, container_type>;
+
+        private:
+            enum : unsigned char {
+                finite, not_a_number, infinite
+            };
+
+        public:
+            constexpr natural_fixed()noexcept:
+                _limbs() {}
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            HWSHQTB_CONSTEXPR14 natural_fixed(Integer v)noexcept:
+                _limbs() {
+                assign(v);
+            }
+            // NaN and infinity become zero and larger values keep their low bits when special values are off
+            template <class Container, class Policy>
+            HWSHQTB_CONSTEXPR14 explicit natural_fixed(const natural<value_type, Container, Policy>& x)noexcept:
+                _limbs() {
+                if (x.is_NaN() || x.is_inf()) {
+                    if HWSHQTB_CONSTEXPR17(Special) {
+                        if (x.is_NaN()) to_NaN();
+                        else to_inf();
+                    }
+                    return;
+                }
+                if HWSHQTB_CONSTEXPR17(Special)
+                    if (x.bit_width() > Bits) {
+                        to_inf();
+                        return;
+                    }
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] = x[i];
+                });
+            }
+
+            // negative values give infinity, or wrap around modulo 2^Bits when special values are off
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            HWSHQTB_CONSTEXPR14 void assign(Integer v)noexcept {
+                constexpr size_type digits = std::numeric_limits<Integer>::digits + std::numeric_limits<Integer>::is_signed;
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (v < 0) {
+                        to_inf();
+                        return;
+                    }
+                    this->_state = finite;
+                }
+                const value_type fill = v < 0 ? ~(value_type)0 : 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    constexpr size_type shift = decltype(i)::value * type_width;
+                    if HWSHQTB_CONSTEXPR17(shift < digits) _limbs[i] = (value_type)(v >> shift);
+                    else _limbs[i] = fill;
+                });
+            }
+
+            // *this = y[0, ny), least significant limb first, infinity when it does not fit
+            // or its low limbs when special values are off
+            HWSHQTB_CONSTEXPR14 natural_fixed& assign_limbs(const value_type* y, size_type ny)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (kernel::normalized_length(y, ny) > limb_count) return to_inf();
+                    this->_state = finite;
+                }
+                _limbs = container_type();
+                for (size_type i = 0; i < ny && i < limb_count; ++i)
+                    _limbs[i] = y[i];
+                return *this;
+            }
+
+            constexpr value_type operator[](std::size_t index)const noexcept {
+                return _limbs[index];
+            }
+            // limbs of the value, least significant first, meaningless for NaN and infinity
+            constexpr const container_type& memory()const noexcept {
+                return _limbs;
+            }
+
+            constexpr bool is_NaN()const noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) return this->_state == not_a_number;
+                else return false;
+            }
+            constexpr bool is_inf()const noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) return this->_state == infinite;
+                else return false;
+            }
+            HWSHQTB_CONSTEXPR14 bool is_zero()const noexcept {
+                return !is_NaN() && !is_inf() && top_limb(_limbs) == 0 && _limbs[0] == 0;
+            }
+            // number of significant bits, 0 for zero and special values
+            HWSHQTB_CONSTEXPR14 size_type bit_width()const noexcept {
+                if (is_NaN() || is_inf()) return 0;
+                return bit_width(_limbs);
+            }
+
+            HWSHQTB_CONSTEXPR14 natural_fixed& to_NaN()noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) this->_state = not_a_number;
+                else _limbs = container_type();
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& to_zero()noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) this->_state = finite;
+                _limbs = container_type();
+                return *this;
+            }
+            // without special values infinity is the largest value, the closest finite stand-in
+            HWSHQTB_CONSTEXPR14 natural_fixed& to_inf()noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) this->_state = infinite;
+                else to_max();
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& to_max()noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) this->_state = finite;
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] = ~(value_type)0;
+                });
+                return *this;
+            }
+
+            static HWSHQTB_CONSTEXPR14 natural_fixed NaN()noexcept {
+                natural_fixed result;
+                return result.to_NaN();
+            }
+            static constexpr natural_fixed zero()noexcept {
+                return natural_fixed();
+            }
+            static HWSHQTB_CONSTEXPR14 natural_fixed infinity()noexcept {
+                natural_fixed result;
+                return result.to_inf();
+            }
+            static HWSHQTB_CONSTEXPR14 natural_fixed max()noexcept {
+                natural_fixed result;
+                return result.to_max();
+            }
+
+            // special values follow the tables of natural, a carry out of the top limb gives infinity
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator+=(const natural_fixed& other)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (is_NaN()) return *this;
+                    if (other.is_NaN()) return to_NaN();
+                    if (is_inf()) return *this;
+                    if (other.is_inf()) return to_inf();
+                    if (add_n(_limbs, _limbs, other._limbs)) return to_inf();
+                }
+                else add_n(_limbs, _limbs, other._limbs);
+                return *this;
+            }
+            // a borrow out of the top limb gives infinity, as for natural
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator-=(const natural_fixed& other)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (is_NaN()) return *this;
+                    if (other.is_NaN() || (is_inf() && other.is_inf())) return to_NaN();
+                    if (is_inf()) return *this;
+                    if (other.is_inf()) return to_inf();
+                    if (sub_n(_limbs, _limbs, other._limbs)) return to_inf();
+                }
+                else sub_n(_limbs, _limbs, other._limbs);
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator*=(const natural_fixed& other)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (is_NaN()) return *this;
+                    if (other.is_NaN() || (is_zero() && other.is_inf()) || (other.is_zero() && is_inf())) return to_NaN();
+                    if (is_inf()) return *this;
+                    if (other.is_inf()) return to_inf();
+                    if (mul_n(_limbs, _limbs, other._limbs)) return to_inf();
+                }
+                else mul_n(_limbs, _limbs, other._limbs);
+                return *this;
+            }
+            // division by zero gives NaN, or zero when special values are off
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator/=(const natural_fixed& other)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (is_NaN()) return *this;
+                    if (other.is_NaN() || other.is_zero() || (is_inf() && other.is_inf())) return to_NaN();
+                    if (other.is_inf()) return to_zero();
+                    if (is_inf()) return *this;
+                }
+                else if (other.is_zero()) return to_zero();
+                container_type quotient = {};
+                divide(quotient, _limbs, other._limbs);
+                _limbs = quotient;
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator%=(const natural_fixed& other)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (is_NaN()) return *this;
+                    if (other.is_NaN() || other.is_zero() || is_inf()) return to_NaN();
+                    if (other.is_inf()) return *this;
+                }
+                else if (other.is_zero()) return to_zero();
+                container_type quotient = {};
+                divide(quotient, _limbs, other._limbs);
+                return *this;
+            }
+            // *this becomes the remainder, returns the quotient
+            HWSHQTB_CONSTEXPR14 natural_fixed div(const natural_fixed& other)noexcept {
+                natural_fixed quotient(*this);
+                quotient /= other;
+                operator%=(other);
+                return quotient;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& square()noexcept {
+                return operator*=(*this);
+            }
+
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator&=(const natural_fixed& other)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (is_NaN()) return *this;
+                    if (other.is_NaN()) return to_NaN();
+                    if (is_zero()) return *this;
+                    if (other.is_zero()) return to_zero();
+                    if (is_inf()) return *this;
+                    if (other.is_inf()) return to_inf();
+                }
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] &= other._limbs[i];
+                });
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator|=(const natural_fixed& other)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (is_NaN()) return *this;
+                    if (other.is_NaN()) return to_NaN();
+                    if (is_inf()) return *this;
+                    if (other.is_inf()) return to_inf();
+                }
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] |= other._limbs[i];
+                });
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator^=(const natural_fixed& other)noexcept {
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    if (is_NaN() || is_inf()) return *this;
+                    if (other.is_NaN()) return to_NaN();
+                    if (other.is_inf()) return to_inf();
+                }
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] ^= other._limbs[i];
+                });
+                return *this;
+            }
+            // flips all `Bits` bits
+            HWSHQTB_CONSTEXPR14 natural_fixed& flip()noexcept {
+                if (is_NaN() || is_inf()) return *this;
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] = ~_limbs[i];
+                });
+                return *this;
+            }
+            // bits shifted out of the top give infinity, or are dropped when special values are off
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator<<=(size_type count)noexcept {
+                if (is_NaN() || is_inf() || count == 0) return *this;
+                if HWSHQTB_CONSTEXPR17(Special) {
+                    const size_type width = bit_width(_limbs);
+                    if (width == 0) return *this;
+                    if (count > Bits - width) return to_inf();
+                }
+                else if (count >= Bits) return to_zero();
+                shift_left(_limbs, _limbs, count);
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator>>=(size_type count)noexcept {
+                if (is_NaN() || is_inf() || count == 0) return *this;
+                if (count >= Bits) return to_zero();
+                shift_right(_limbs, _limbs, count);
+                return *this;
+            }
+
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator++()noexcept {
+                if (is_NaN() || is_inf()) return *this;
+                value_type carry = 1;
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] = kernel::add_carry(_limbs[i], (value_type)0, carry);
+                });
+                if HWSHQTB_CONSTEXPR17(Special)
+                    if (carry) to_inf();
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed operator++(int)noexcept {
+                natural_fixed result(*this);
+                operator++();
+                return result;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed& operator--()noexcept {
+                if (is_NaN() || is_inf()) return *this;
+                value_type borrow = 1;
+                kernel::unroll<limb_count>([&](auto i) {
+                    _limbs[i] = kernel::sub_borrow(_limbs[i], (value_type)0, borrow);
+                });
+                if HWSHQTB_CONSTEXPR17(Special)
+                    if (borrow) to_inf();
+                return *this;
+            }
+            HWSHQTB_CONSTEXPR14 natural_fixed operator--(int)noexcept {
+                natural_fixed result(*this);
+                operator--();
+                return result;
+            }
+
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator+(natural_fixed x, const natural_fixed& y)noexcept {
+                return x += y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator-(natural_fixed x, const natural_fixed& y)noexcept {
+                return x -= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator*(natural_fixed x, const natural_fixed& y)noexcept {
+                return x *= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator/(natural_fixed x, const natural_fixed& y)noexcept {
+                return x /= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator%(natural_fixed x, const natural_fixed& y)noexcept {
+                return x %= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator&(natural_fixed x, const natural_fixed& y)noexcept {
+                return x &= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator|(natural_fixed x, const natural_fixed& y)noexcept {
+                return x |= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator^(natural_fixed x, const natural_fixed& y)noexcept {
+                return x ^= y;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator~(natural_fixed x)noexcept {
+                return x.flip();
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator<<(natural_fixed x, size_type count)noexcept {
+                return x <<= count;
+            }
+            friend HWSHQTB_CONSTEXPR14 natural_fixed operator>>(natural_fixed x, size_type count)noexcept {
+                return x >>= count;
+            }
+
+            // comparisons involving NaN or infinity are false, except that infinity != x holds for x other than NaN
+            friend HWSHQTB_CONSTEXPR14 bool operator==(const natural_fixed& x, const natural_fixed& y)noexcept {
+                if (x.is_NaN() || x.is_inf() || y.is_NaN() || y.is_inf()) return false;
+                return equal(x._limbs, y._limbs);
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator!=(const natural_fixed& x, const natural_fixed& y)noexcept {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                if (x.is_inf() || y.is_inf()) return true;
+                return !equal(x._limbs, y._limbs);
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator<(const natural_fixed& x, const natural_fixed& y)noexcept {
+                if (x.is_NaN() || x.is_inf() || y.is_NaN() || y.is_inf()) return false;
+                return less(x._limbs, y._limbs);
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator<=(const natural_fixed& x, const natural_fixed& y)noexcept {
+                if (x.is_NaN() || x.is_inf() || y.is_NaN() || y.is_inf()) return false;
+                return !less(y._limbs, x._limbs);
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator>(const natural_fixed& x, const natural_fixed& y)noexcept {
+                if (x.is_NaN() || x.is_inf() || y.is_NaN() || y.is_inf()) return false;
+                return less(y._limbs, x._limbs);
+            }
+            friend HWSHQTB_CONSTEXPR14 bool operator>=(const natural_fixed& x, const natural_fixed& y)noexcept {
+                if (x.is_NaN() || x.is_inf() || y.is_NaN() || y.is_inf()) return false;
+                return !less(x._limbs, y._limbs);
+            }
+
+            // the low bits, as for natural
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            HWSHQTB_CONSTEXPR14 explicit operator Integer()const noexcept {
+                using unsigned_type = std::make_unsigned_t<Integer>;
+                constexpr size_type digits = std::numeric_limits<unsigned_type>::digits;
+                unsigned_type result = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    constexpr size_type shift = decltype(i)::value * type_width;
+                    if HWSHQTB_CONSTEXPR17(shift < digits) result |= (unsigned_type)((unsigned_type)_limbs[i] << shift);
+                });
+                return (Integer)result;
+            }
+            template <class Container, class Policy>
+            HWSHQTB_CONSTEXPR14 explicit operator natural<value_type, Container, Policy>()const {
+                natural<value_type, Container, Policy> result;
+                if (is_NaN()) result.to_NaN();
+                else if (is_inf()) result.to_inf();
+                else result.assign_limbs(_limbs.data(), limb_count);
+                return result;
+            }
+
+            // digits of `base` as for natural
+            friend std::to_chars_result to_chars(char* first, char* last, const natural_fixed& x, int base = 10) {
+                return to_chars(first, last, (natural_type)x, base);
+            }
+            // NaN and infinity are rejected when special values are off
+            friend std::from_chars_result from_chars(const char* first, const char* last, natural_fixed& x, int base = 10) {
+                natural_type n;
+                const std::from_chars_result result = from_chars(first, last, n, base);
+                if (result.ec != std::errc()) return result;
+                if HWSHQTB_CONSTEXPR17(!Special)
+                    if (n.is_NaN() || n.is_inf()) return {first, std::errc::invalid_argument};
+                x = natural_fixed(n);
+                return result;
+            }
+            template <class CharT, class Traits>
+            friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const natural_fixed& x) {
+                const std::ios_base::fmtflags basefield = os.flags() & std::ios_base::basefield;
+                const int base = basefield == std::ios_base::hex ? 16 : basefield == std::ios_base::oct ? 8 : 10;
+                std::string text(Bits + 1, '\0');
+                const std::to_chars_result result = to_chars(text.data(), text.data() + text.size(), x, base);
+                text.resize((std::size_t)(result.ptr - text.data()));
+                if (os.flags() & std::ios_base::uppercase)
+                    for (char& c : text) c = (char)std::toupper((unsigned char)c);
+                for (char c : text) os << os.widen(c);
+                return os;
+            }
+            template <class CharT, class Traits>
+            friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, natural_fixed& x) {
+                typename std::basic_istream<CharT, Traits>::sentry check_sentry(is);
+                if (!check_sentry) return is;
+                const std::ios_base::fmtflags basefield = is.flags() & std::ios_base::basefield;
+                const int base = basefield == std::ios_base::hex ? 16 : basefield == std::ios_base::oct ? 8 : 10;
+                std::string text;
+                for (typename Traits::int_type c = is.peek(); !Traits::eq_int_type(c, Traits::eof()); c = is.peek()) {
+                    const char narrow = is.narrow(Traits::to_char_type(c), '\0');
+                    if (!std::isalnum((unsigned char)narrow)) break;
+                    text.push_back(narrow);
+                    is.get();
+                }
+                const std::from_chars_result result = from_chars(text.data(), text.data() + text.size(), x, base);
+                if (result.ec != std::errc() || result.ptr != text.data() + text.size()) is.setstate(std::ios_base::failbit);
+                return is;
+            }
+
+        private:
+            // index of the highest non-zero limb, 0 for zero
+            static HWSHQTB_CONSTEXPR14 size_type top_limb(const container_type& x)noexcept {
+                size_type top = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    if (x[i]) top = i;
+                });
+                return top;
+            }
+            static HWSHQTB_CONSTEXPR14 size_type bit_width(const container_type& x)noexcept {
+                const size_type top = top_limb(x);
+                return (top + 1) * type_width - kernel::count_leading_zeros(x[top]);
+            }
+
+            // r = x + y, returns the carry-out
+            static HWSHQTB_CONSTEXPR14 value_type add_n(container_type& r, const container_type& x, const container_type& y)noexcept {
+                value_type carry = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    r[i] = kernel::add_carry(x[i], y[i], carry);
+                });
+                return carry;
+            }
+            // r = x - y, returns the borrow-out
+            static HWSHQTB_CONSTEXPR14 value_type sub_n(container_type& r, const container_type& x, const container_type& y)noexcept {
+                value_type borrow = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    r[i] = kernel::sub_borrow(x[i], y[i], borrow);
+                });
+                return borrow;
+            }
+            // r = x * y mod 2^Bits, only the products landing below 2^Bits are formed
+            // returns whether the full product reaches 2^Bits, r may alias x or y
+            static HWSHQTB_CONSTEXPR14 bool mul_n(container_type& r, const container_type& x, const container_type& y)noexcept {
+                container_type product = {};
+                const size_type nx = Special ? top_limb(x) + 1 : 0;
+                bool overflow = false;
+                kernel::unroll<limb_count>([&](auto i) {
+                    constexpr size_type k = decltype(i)::value;
+                    value_type carry = 0;
+                    kernel::unroll<limb_count - k>([&](auto j) {
+                        product[k + j] = kernel::mul_add(x[j], y[k], product[k + j], carry);
+                    });
+                    // a carry out of the row or a dropped product x[j] y[k] with j + k >= limb_count
+                    if HWSHQTB_CONSTEXPR17(Special) overflow |= carry != 0 || (y[k] != 0 && nx + k > limb_count);
+                });
+                r = product;
+                return overflow;
+            }
+            // quotient = x / y and x = x % y for y != 0
+            static HWSHQTB_CONSTEXPR14 void divide(container_type& quotient, container_type& x, const container_type& y)noexcept {
+                quotient = container_type();
+                const size_type nx = top_limb(x) + 1, ny = top_limb(y) + 1;
+                if (nx < ny || less(x, y)) return;
+                if (ny == 1) {
+                    const value_type remainder = kernel::divrem_1(quotient.data(), x.data(), nx, y[0]);
+                    x = container_type();
+                    x[0] = remainder;
+                    return;
+                }
+                value_type scratch[kernel::divrem_scratch_size(limb_count, limb_count)] = {};
+                kernel::divrem(quotient.data(), x.data(), nx, y.data(), ny, scratch);
+                for (size_type i = ny; i < nx; ++i) x[i] = 0;
+            }
+            // x < y from the borrow of x - y, no early exit
+            static HWSHQTB_CONSTEXPR14 bool less(const container_type& x, const container_type& y)noexcept {
+                value_type borrow = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    kernel::sub_borrow(x[i], y[i], borrow);
+                });
+                return borrow != 0;
+            }
+            static HWSHQTB_CONSTEXPR14 bool equal(const container_type& x, const container_type& y)noexcept {
+                value_type difference = 0;
+                kernel::unroll<limb_count>([&](auto i) {
+                    difference |= x[i] ^ y[i];
+                });
+                return difference == 0;
+            }
+            // r = x << count mod 2^Bits for count < Bits, r may alias x
+            static HWSHQTB_CONSTEXPR14 void shift_left(container_type& r, const container_type& x, size_type count)noexcept {
+                const size_type limbs = count / type_width, bits = count % type_width;
+                container_type result = {};
+                kernel::unroll<limb_count>([&](auto i) {
+                    constexpr size_type k = decltype(i)::value;
+                    if (k < limbs) return;
+                    result[k] = x[k - limbs] << bits;
+                    if (bits && k > limbs) result[k] |= x[k - limbs - 1] >> (type_width - bits);
+                });
+                r = result;
+            }
+            // r = x >> count for count < Bits, r may alias x
+            static HWSHQTB_CONSTEXPR14 void shift_right(container_type& r, const container_type& x, size_type count)noexcept {
+                const size_type limbs = count / type_width, bits = count % type_width;
+                container_type result = {};
+                kernel::unroll<limb_count>([&](auto i) {
+                    constexpr size_type k = decltype(i)::value;
+                    if (k + limbs >= limb_count) return;
+                    result[k] = x[k + limbs] >> bits;
+                    if (bits && k + limbs + 1 < limb_count) result[k] |= x[k + limbs + 1] << (type_width - bits);
+                });
+                r = result;
+            }
+
+            container_type _limbs;
+
+        };
+
+        template <std::size_t Bits>
+        using natural_wrapping = natural_fixed<Bits, std::size_t, false>;
+    }
+}
+
+namespace std {
+    template <std::size_t Bits, typename T, bool Special>
+    struct hash<hwshqtb::big_number::natural_fixed<Bits, T, Special>> {
+        std::size_t operator()(const hwshqtb::big_number::natural_fixed<Bits, T, Special>& x)const noexcept {
+            std::size_t seed = x.is_NaN() ? 1 : x.is_inf() ? 2 : 0;
+            if (x.is_NaN() || x.is_inf()) return seed;
+            hwshqtb::big_number::kernel::unroll<hwshqtb::big_number::natural_fixed<Bits, T, Special>::limb_count>([&](auto i) {
+                seed ^= std::hash<T>()(x[i]) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+            });
+            return seed;
+        }
+    };
+
+    template <std::size_t Bits, typename T, bool Special>
+    class numeric_limits<hwshqtb::big_number::natural_fixed<Bits, T, Special>>: public numeric_limits<T> {
+        using natural_type = hwshqtb::big_number::natural_fixed<Bits, T, Special>;
+
+    public:
+        static constexpr bool has_infinity = Special;
+        static constexpr bool has_quiet_NaN = Special;
+        static constexpr bool has_signaling_NaN = false;
+        static constexpr bool is_modulo = !Special;
+        static constexpr int digits = (int)Bits;
+        static constexpr int digits10 = (int)(Bits * 30103 / 100000);
+
+        static constexpr natural_type min() noexcept {
+            return natural_type();
+        }
+        static constexpr natural_type lowest() noexcept {
+            return natural_type();
+        }
+        static HWSHQTB_CONSTEXPR14 natural_type max() noexcept {
+            return natural_type::max();
+        }
+        static constexpr natural_type epsilon() noexcept {
+            return natural_type();
+        }
+        static constexpr natural_type round_error() noexcept {
+            return natural_type();
+        }
+        static HWSHQTB_CONSTEXPR14 natural_type infinity() noexcept {
+            return natural_type::infinity();
+        }
+        static HWSHQTB_CONSTEXPR14 natural_type quiet_NaN() noexcept {
+            return natural_type::NaN();
+        }
+        static HWSHQTB_CONSTEXPR14 natural_type signaling_NaN() noexcept {
+            return natural_type::NaN();
+        }
+        static constexpr natural_type denorm_min() noexcept {
+            return natural_type();
+        }
+    };
+}
+
+#endif
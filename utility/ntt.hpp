@@ -0,0 +1,294 @@
+#ifndef HWSHQTB__BIG_NUMBER__NTT_HPP
+#define HWSHQTB__BIG_NUMBER__NTT_HPP
+
+#include "arena.hpp"
+#include "task_pool.hpp"
+
+namespace hwshqtb {
+    namespace big_number {
+        namespace kernel {
+            // prime field Z/pZ for p = c * 2^50 + 1 < 2^62, multiplication in Montgomery form (R = 2^64)
+            // elements are always kept in [0, p)
+            class ntt_prime {
+                using word_type = std::uint64_t;
+                using wide_type = uint_t<128>;
+
+                static constexpr word_type negative_inverse(word_type p, word_type inverse = 1, std::size_t bits = 1)noexcept {
+                    return bits >= 64 ? (word_type)0 - inverse : negative_inverse(p, inverse * (2 - p * inverse), bits * 2);
+                }
+
+            public:
+                static constexpr std::size_t max_log_size = 50;
+
+                constexpr ntt_prime(word_type modulus, word_type root)noexcept:
+                    _modulus(modulus), _root(root), _inverse(negative_inverse(modulus)),
+                    _r2((word_type)(((wide_type)(((wide_type)1 << 64) % modulus) * (word_type)(((wide_type)1 << 64) % modulus)) % modulus)) {}
+
+                constexpr word_type modulus()const noexcept {
+                    return _modulus;
+                }
+                constexpr word_type primitive_root()const noexcept {
+                    return _root;
+                }
+
+                // x * y / R mod p
+                HWSHQTB_CONSTEXPR14 word_type mul(word_type x, word_type y)const noexcept {
+                    wide_type t = (wide_type)x * y;
+                    word_type m = (word_type)t * _inverse;
+                    word_type u = (word_type)((t + (wide_type)m * _modulus) >> 64);
+                    return u >= _modulus ? u - _modulus : u;
+                }
+                constexpr word_type add(word_type x, word_type y)const noexcept {
+                    return x + y >= _modulus ? x + y - _modulus : x + y;
+                }
+                constexpr word_type sub(word_type x, word_type y)const noexcept {
+                    return x >= y ? x - y : x + _modulus - y;
+                }
+                HWSHQTB_CONSTEXPR14 word_type reduce(word_type x)const noexcept {
+                    while (x >= _modulus) x -= _modulus;
+                    return x;
+                }
+                // x * R mod p
+                HWSHQTB_CONSTEXPR14 word_type to_montgomery(word_type x)const noexcept {
+                    return mul(reduce(x), _r2);
+                }
+                // x^e in Montgomery form, x in Montgomery form
+                HWSHQTB_CONSTEXPR14 word_type pow(word_type x, word_type e)const noexcept {
+                    word_type result = to_montgomery(1);
+                    for (; e; e >>= 1, x = mul(x, x))
+                        if (e & 1) result = mul(result, x);
+                    return result;
+                }
+                // x^-1 in Montgomery form, x in Montgomery form
+                HWSHQTB_CONSTEXPR14 word_type inverse(word_type x)const noexcept {
+                    return pow(x, _modulus - 2);
+                }
+
+            private:
+                word_type _modulus, _root, _inverse, _r2;
+
+            };
+
+            constexpr ntt_prime ntt_primes[3] = {
+                {4601552919265804289ull, 3},
+                {4546383823830515713ull, 10},
+                {4522739925786820609ull, 37}
+            };
+
+            // limb count above which the three primes can no longer represent every convolution coefficient exactly
+            constexpr std::size_t ntt_max_size = (std::size_t)1 << ntt_prime::max_log_size;
+
+            // twiddle[len + j] = w^j in Montgomery form for the primitive 2len-th root w, len = 1, 2, ..., n / 2
+            // a nonzero grain fills the wide levels in parallel, each chunk starting from its own power of w
+            inline void ntt_twiddles(std::uint64_t* twiddle, std::size_t n, const ntt_prime& field, bool inverse, std::size_t grain = 0) {
+                for (std::size_t len = 1; len < n; len <<= 1) {
+                    std::uint64_t w = field.pow(field.to_montgomery(field.primitive_root()), (field.modulus() - 1) / (2 * len));
+                    if (inverse) w = field.inverse(w);
+                    auto fill = [twiddle, len, w, &field](std::size_t first, std::size_t last) {
+                        std::uint64_t power = field.pow(w, first);
+                        for (std::size_t j = first; j < last; ++j, power = field.mul(power, w))
+                            twiddle[len + j] = power;
+                    };
+                    if (grain != 0 && len >= 2 * grain) parallel_for(0, len, grain, fill);
+                    else fill(0, len);
+                }
+            }
+            // decimation in frequency, natural order in, bit-reversed order out
+            inline void ntt_forward(std::uint64_t* a, std::size_t n, const ntt_prime& field, const std::uint64_t* twiddle) {
+                for (std::size_t len = n >> 1; len > 0; len >>= 1)
+                    for (std::size_t i = 0; i < n; i += 2 * len)
+                        for (std::size_t j = 0; j < len; ++j) {
+                            std::uint64_t u = a[i + j], v = a[i + j + len];
+                            a[i + j] = field.add(u, v);
+                            a[i + j + len] = field.mul(field.sub(u, v), twiddle[len + j]);
+                        }
+            }
+            // decimation in time, bit-reversed order in, natural order out (unscaled)
+            inline void ntt_inverse(std::uint64_t* a, std::size_t n, const ntt_prime& field, const std::uint64_t* twiddle) {
+                for (std::size_t len = 1; len < n; len <<= 1)
+                    for (std::size_t i = 0; i < n; i += 2 * len)
+                        for (std::size_t j = 0; j < len; ++j) {
+                            std::uint64_t u = a[i + j], v = field.mul(a[i + j + len], twiddle[len + j]);
+                            a[i + j] = field.add(u, v);
+                            a[i + j + len] = field.sub(u, v);
+                        }
+            }
+
+            // f(begin, end) over [0, n), in parallel chunks of at least `grain` when grain is nonzero
+            template <class F>
+            void ntt_for(std::size_t n, std::size_t grain, F f) {
+                if (grain != 0 && n >= 2 * grain) parallel_for(0, n, grain, f);
+                else f(0, n);
+            }
+            // size of the sub-transforms that run as one task, a power of two giving a few per thread
+            inline std::size_t ntt_block(std::size_t n, std::size_t grain) {
+                const std::size_t target = std::max(2 * grain, n / (4 * task_pool::instance().concurrency()));
+                std::size_t block = 2;
+                while (2 * block <= target && 2 * block <= n) block <<= 1;
+                return block;
+            }
+            // butterflies [first, last) of the stage with half-length len, butterfly t is a[i + j], a[i + j + len]
+            // with i = t / len * 2 len and j = t % len
+            template <bool Forward>
+            void ntt_butterflies(std::uint64_t* a, std::size_t len, std::size_t first, std::size_t last, const ntt_prime& field, const std::uint64_t* twiddle) {
+                for (std::size_t t = first; t < last;) {
+                    std::uint64_t* p = a + t / len * 2 * len;
+                    for (std::size_t j = t % len; j < len && t < last; ++j, ++t) {
+                        if (Forward) {
+                            std::uint64_t u = p[j], v = p[j + len];
+                            p[j] = field.add(u, v);
+                            p[j + len] = field.mul(field.sub(u, v), twiddle[len + j]);
+                        }
+                        else {
+                            std::uint64_t u = p[j], v = field.mul(p[j + len], twiddle[len + j]);
+                            p[j] = field.add(u, v);
+                            p[j + len] = field.sub(u, v);
+                        }
+                    }
+                }
+            }
+            // ntt_forward with the stages wider than a block split across the pool,
+            // after which the blocks are independent and finish their stages as one task each
+            inline void ntt_forward_parallel(std::uint64_t* a, std::size_t n, const ntt_prime& field, const std::uint64_t* twiddle, std::size_t grain) {
+                const std::size_t block = ntt_block(n, grain);
+                for (std::size_t len = n >> 1; 2 * len > block; len >>= 1)
+                    parallel_for(0, n / 2, grain, [=, &field](std::size_t first, std::size_t last) {
+                        ntt_butterflies<true>(a, len, first, last, field, twiddle);
+                    });
+                parallel_for(0, n / block, 1, [=, &field](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i)
+                        ntt_forward(a + i * block, block, field, twiddle);
+                });
+            }
+            // ntt_inverse mirrored, the blocks first and the wide stages last
+            inline void ntt_inverse_parallel(std::uint64_t* a, std::size_t n, const ntt_prime& field, const std::uint64_t* twiddle, std::size_t grain) {
+                const std::size_t block = ntt_block(n, grain);
+                parallel_for(0, n / block, 1, [=, &field](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i)
+                        ntt_inverse(a + i * block, block, field, twiddle);
+                });
+                for (std::size_t len = block; len < n; len <<= 1)
+                    parallel_for(0, n / 2, grain, [=, &field](std::size_t first, std::size_t last) {
+                        ntt_butterflies<false>(a, len, first, last, field, twiddle);
+                    });
+            }
+
+            // r[0, nx + ny) = x[0, nx) * y[0, ny) by three-prime number theoretic transform and CRT
+            // y == x with nx == ny squares with a single forward transform per prime
+            // a nonzero grain runs the three primes as parallel tasks, each with its transforms
+            // and pointwise loops split across the pool in chunks of at least `grain`
+            template <typename T>
+            void mul_ntt(T* r, const T* x, std::size_t nx, const T* y, std::size_t ny, std::size_t grain = 0) {
+                static_assert(limb_traits<T>::width <= 64, "limb wider than 64 bits");
+                constexpr std::size_t width = limb_traits<T>::width;
+                const bool square = x == y && nx == ny;
+                const std::size_t coefficients = nx + ny - 1;
+                std::size_t n = 1;
+                while (n < coefficients) n <<= 1;
+                if (grain != 0 && n < 2 * grain) grain = 0;
+
+                // twiddles, a and b for one prime at a time, or for each prime when they run in parallel
+                const std::size_t stride = (square ? 2 : 3) * n;
+                scratch_buffer<std::uint64_t> buffer((grain != 0 ? 3 : 1) * stride), residues(3 * coefficients);
+                // the prime is a constant of each instantiation, so its Montgomery arithmetic folds
+                auto transform = [&](auto prime, std::uint64_t* twiddle) {
+                    constexpr std::size_t k = decltype(prime)::value;
+                    const ntt_prime& field = ntt_primes[k];
+                    std::uint64_t* a = twiddle + n;
+                    std::uint64_t* b = a + n;
+                    auto forward = [&](std::uint64_t* v, const T* z, std::size_t nz) {
+                        ntt_for(n, grain, [&](std::size_t first, std::size_t last) {
+                            for (std::size_t i = first; i < last; ++i)
+                                v[i] = i < nz ? field.reduce(z[i]) : 0;
+                        });
+                        if (grain != 0) ntt_forward_parallel(v, n, field, twiddle, grain);
+                        else ntt_forward(v, n, field, twiddle);
+                    };
+                    ntt_twiddles(twiddle, n, field, false, grain);
+                    forward(a, x, nx);
+                    if (!square) forward(b, y, ny);
+                    ntt_for(n, grain, [&](std::size_t first, std::size_t last) {
+                        for (std::size_t i = first; i < last; ++i)
+                            a[i] = field.mul(a[i], square ? a[i] : b[i]);
+                    });
+                    ntt_twiddles(twiddle, n, field, true, grain);
+                    if (grain != 0) ntt_inverse_parallel(a, n, field, twiddle, grain);
+                    else ntt_inverse(a, n, field, twiddle);
+                    // pointwise products carry an extra R^-1, fold it into the 1/n scaling
+                    const std::uint64_t scale = field.to_montgomery(field.inverse(field.to_montgomery(n)));
+                    ntt_for(coefficients, grain, [&](std::size_t first, std::size_t last) {
+                        for (std::size_t i = first; i < last; ++i)
+                            residues[k * coefficients + i] = field.mul(a[i], scale);
+                    });
+                };
+                if (grain != 0) {
+                    task_group group;
+                    group.run([&] {
+                        transform(std::integral_constant<std::size_t, 1>(), buffer.data() + stride);
+                    });
+                    group.run([&] {
+                        transform(std::integral_constant<std::size_t, 2>(), buffer.data() + 2 * stride);
+                    });
+                    transform(std::integral_constant<std::size_t, 0>(), buffer.data());
+                    group.wait();
+                }
+                else {
+                    transform(std::integral_constant<std::size_t, 0>(), buffer.data());
+                    transform(std::integral_constant<std::size_t, 1>(), buffer.data());
+                    transform(std::integral_constant<std::size_t, 2>(), buffer.data());
+                }
+
+                // Garner's reconstruction, c = v1 + v2 p1 + v3 p1 p2 < 2^192 written over the residues of coefficient i,
+                // then carry c into the limbs
+                const ntt_prime& f2 = ntt_primes[1];
+                const ntt_prime& f3 = ntt_primes[2];
+                const std::uint64_t p1 = ntt_primes[0].modulus(), p2 = f2.modulus();
+                const std::uint64_t inverse_p1_p2 = f2.inverse(f2.to_montgomery(p1));
+                const std::uint64_t inverse_p1_p3 = f3.inverse(f3.to_montgomery(p1));
+                const std::uint64_t inverse_p2_p3 = f3.inverse(f3.to_montgomery(p2));
+                const uint_t<128> p1p2 = (uint_t<128>)p1 * p2;
+                std::uint64_t* c0 = residues.data();
+                std::uint64_t* c1 = c0 + coefficients;
+                std::uint64_t* c2 = c1 + coefficients;
+                ntt_for(coefficients, grain, [&](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i) {
+                        const std::uint64_t v1 = c0[i];
+                        const std::uint64_t v2 = f2.mul(f2.sub(c1[i], f2.reduce(v1)), inverse_p1_p2);
+                        const std::uint64_t v3 = f3.mul(f3.sub(f3.mul(f3.sub(c2[i], f3.reduce(v1)), inverse_p1_p3), f3.reduce(v2)), inverse_p2_p3);
+                        // v3 * p1p2 + v2 * p1 + v1
+                        uint_t<128> low = (uint_t<128>)v3 * (std::uint64_t)p1p2;
+                        uint_t<128> high = (uint_t<128>)v3 * (std::uint64_t)(p1p2 >> 64) + (std::uint64_t)(low >> 64);
+                        uint_t<128> middle = (uint_t<128>)v2 * p1 + v1;
+                        std::uint64_t carry = 0;
+                        c0[i] = add_carry((std::uint64_t)low, (std::uint64_t)middle, carry);
+                        c1[i] = add_carry((std::uint64_t)high, (std::uint64_t)(middle >> 64), carry);
+                        c2[i] = (std::uint64_t)(high >> 64) + carry;
+                    }
+                });
+                std::uint64_t accumulator[4] = {0, 0, 0, 0};
+                for (std::size_t i = 0; i < nx + ny; ++i) {
+                    if (i < coefficients) {
+                        std::uint64_t carry = 0;
+                        accumulator[0] = add_carry(accumulator[0], c0[i], carry);
+                        accumulator[1] = add_carry(accumulator[1], c1[i], carry);
+                        accumulator[2] = add_carry(accumulator[2], c2[i], carry);
+                        accumulator[3] += carry;
+                    }
+                    if (width == 64) {
+                        r[i] = (T)accumulator[0];
+                        accumulator[0] = accumulator[1];
+                        accumulator[1] = accumulator[2];
+                        accumulator[2] = accumulator[3];
+                        accumulator[3] = 0;
+                    }
+                    else {
+                        r[i] = (T)accumulator[0];
+                        rshift(accumulator, accumulator, 4, width % 64);
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef HWSHQTB__BIG_NUMBER__PRIME_HPP
+#define HWSHQTB__BIG_NUMBER__PRIME_HPP
+
+#include "modular.hpp"
+#include <random>
+#include <vector>
+
+namespace hwshqtb {
+    namespace big_number {
+        namespace kernel {
+            // odd primes below `Limit`, sieved at compile time
+            template <std::size_t Limit>
+            struct prime_table {
+                static_assert(Limit <= 65536, "primes are stored in 16 bits");
+
+                unsigned short primes[Limit / 4 + 8];
+                std::size_t size;
+
+                constexpr prime_table()noexcept:
+                    primes{}, size(0) {
+                    bool composite[Limit] = {};
+                    for (std::size_t i = 3; i < Limit; i += 2) {
+                        if (composite[i]) continue;
+                        primes[size++] = (unsigned short)i;
+                        for (std::size_t j = i * i; j < Limit; j += 2 * i)
+                            composite[j] = true;
+                    }
+                }
+            };
+            inline constexpr prime_table<8192> small_primes{};
+            // table primes tried before the probabilistic tests, the sieve of next_prime uses all of them
+            constexpr std::size_t trial_primes = 256;
+
+            // table primes that fit in a limb, capped at `count`
+            template <typename T>
+            constexpr std::size_t usable_primes(std::size_t count)noexcept {
+                std::size_t i = 0;
+                while (i < count && i < small_primes.size && small_primes.primes[i] <= (T)~(T)0) ++i;
+                return i;
+            }
+            // r[i] = x[0, n) mod small_primes.primes[i] for i < count (at most usable_primes<T>)
+            // primes are multiplied together while the product fits in a limb, so one pass over x serves several
+            template <typename T>
+            HWSHQTB_CONSTEXPR14 void small_prime_residues(unsigned short* r, const T* x, std::size_t n, std::size_t count)noexcept {
+                const unsigned short* primes = small_primes.primes;
+                for (std::size_t i = 0; i < count;) {
+                    T product = primes[i];
+                    std::size_t j = i + 1;
+                    while (j < count && product <= (T)~(T)0 / primes[j])
+                        product = (T)(product * primes[j++]);
+                    const T remainder = mod_1(x, n, product);
+                    for (; i < j; ++i) r[i] = (unsigned short)(remainder % primes[i]);
+                }
+            }
+            // Jacobi symbol (a / m) for odd m
+            HWSHQTB_CONSTEXPR14 int jacobi(std::uint64_t a, std::uint64_t m)noexcept {
+                int result = 1;
+                a %= m;
+                while (a != 0) {
+                    while (a % 2 == 0) {
+                        a /= 2;
+                        if (m % 8 == 3 || m % 8 == 5) result = -result;
+                    }
+                    std::swap(a, m);
+                    if (a % 4 == 3 && m % 4 == 3) result = -result;
+                    a %= m;
+                }
+                return m == 1 ? result : 0;
+            }
+        }
+
+        // probable prime tests for one odd modulus n > 3, the modular context is set up once and shared
+        template <class Natural>
+        class primality {
+        public:
+            using natural_type = Natural;
+            using value_type = typename natural_type::value_type;
+            using size_type = std::size_t;
+
+            // result of trial division
+            enum class screening {
+                composite,
+                prime,
+                unknown
+            };
+
+            explicit primality(const natural_type& n):
+                _n(n), _context(n), _minus_one(n), _d(n), _s(0) {
+                --_minus_one;
+                // n - 1 = d 2^s
+                while (!bit(_minus_one, _s)) ++_s;
+                _d = _minus_one;
+                _d >>= _s;
+            }
+
+            // trial division by the table primes, exact below the square of the last prime tried
+            static screening screen(const natural_type& n) {
+                if (n.is_NaN() || n.is_inf() || n < 2) return screening::composite;
+                if (n[0] % 2 == 0) return n == 2 ? screening::prime : screening::composite;
+                const size_type count = kernel::usable_primes<value_type>(n.bit_width() <= 26 ? kernel::small_primes.size : kernel::trial_primes);
+                std::vector<value_type> limbs(limbs_of(n));
+                std::vector<unsigned short> residues(count);
+                kernel::small_prime_residues(residues.data(), limbs.data(), limbs.size(), count);
+                for (size_type i = 0; i < count; ++i)
+                    if (residues[i] == 0) return n == kernel::small_primes.primes[i] ? screening::prime : screening::composite;
+                const std::uint64_t last = kernel::small_primes.primes[count - 1];
+                return n < last * last ? screening::prime : screening::unknown;
+            }
+
+            // strong probable prime to `base`
+            bool miller_rabin(const natural_type& base)const {
+                natural_type x = _context.pow_mod(base, _d);
+                if (x == 1 || x == _minus_one) return true;
+                for (size_type i = 1; i < _s; ++i) {
+                    x = _context.sqr_mod(x);
+                    if (x == _minus_one) return true;
+                    if (x == 1) return false;
+                }
+                return false;
+            }
+            // strong Lucas probable prime with Selfridge's parameters, P = 1 and Q = (1 - D) / 4 for the first D
+            // of 5, -7, 9, -11, ... with (D / n) = -1
+            bool lucas()const {
+                std::uint64_t magnitude = 5;
+                bool negative = false;
+                while (true) {
+                    natural_type remainder(_n);
+                    remainder %= magnitude;
+                    int symbol = kernel::jacobi((std::uint64_t)remainder, magnitude);
+                    // (-1 / n) and the reciprocity of odd numbers
+                    if (_n[0] % 4 == 3 && (negative != (magnitude % 4 == 3))) symbol = -symbol;
+                    if (symbol == -1) break;
+                    if (symbol == 0 && _n != magnitude) return false;
+                    // no D exists for squares
+                    if (magnitude == 17) {
+                        natural_type root(_n);
+                        root.isqrt();
+                        if (root * root == _n) return false;
+                    }
+                    magnitude += 2;
+                    negative = !negative;
+                }
+                // D and Q modulo n
+                const natural_type d = negative ? _n - magnitude : natural_type(magnitude);
+                const natural_type q = negative ? natural_type((magnitude + 1) / 4) : _n - (magnitude - 1) / 4;
+
+                // n + 1 = k 2^s with s the trailing ones of n, so k = (n >> s) + 1
+                size_type s = 0;
+                while (bit(_n, s)) ++s;
+                natural_type k(_n);
+                k >>= s;
+                ++k;
+
+                natural_type u(1), v(1), qk(q);
+                for (size_type i = k.bit_width() - 1; i-- > 0;) {
+                    u = _context.mul_mod(u, v);
+                    v = sub(_context.sqr_mod(v), add(qk, qk));
+                    qk = _context.sqr_mod(qk);
+                    if (bit(k, i)) {
+                        const natural_type du = _context.mul_mod(d, u);
+                        u = half(add(u, v));
+                        v = half(add(du, v));
+                        qk = _context.mul_mod(qk, q);
+                    }
+                }
+                if (u.is_zero() || v.is_zero()) return true;
+                for (size_type r = 1; r < s; ++r) {
+                    v = sub(_context.sqr_mod(v), add(qk, qk));
+                    if (v.is_zero()) return true;
+                    qk = _context.sqr_mod(qk);
+                }
+                return false;
+            }
+
+        private:
+            static constexpr size_type type_width = kernel::limb_traits<value_type>::width;
+
+            static bool bit(const natural_type& x, size_type position)noexcept {
+                return (x[position / type_width] >> (position % type_width)) & 1;
+            }
+            static std::vector<value_type> limbs_of(const natural_type& n) {
+                std::vector<value_type> limbs((n.bit_width() + type_width - 1) / type_width);
+                for (size_type i = 0; i < limbs.size(); ++i) limbs[i] = n[i];
+                return limbs;
+            }
+            // a + b mod n and a - b mod n for a, b < n, without leaving the capacity of n
+            natural_type add(const natural_type& a, const natural_type& b)const {
+                natural_type complement(_n);
+                complement -= b;
+                if (a >= complement) {
+                    natural_type result(a);
+                    return result -= complement;
+                }
+                return a + b;
+            }
+            natural_type sub(const natural_type& a, const natural_type& b)const {
+                if (a >= b) return a - b;
+                natural_type result(_n);
+                result -= b;
+                return result += a;
+            }
+            // a / 2 mod n, odd a takes (a + n) / 2 = a / 2 + n / 2 + 1
+            natural_type half(const natural_type& a)const {
+                natural_type result(a);
+                result >>= 1;
+                if (a[0] & 1) {
+                    natural_type n(_n);
+                    n >>= 1;
+                    result += n;
+                    ++result;
+                }
+                return result;
+            }
+
+            natural_type _n;
+            montgomery<natural_type> _context;
+            natural_type _minus_one, _d;
+            size_type _s;
+
+        };
+
+        // Miller-Rabin after trial division, exact below 3.3 10^24 by the first 12 or 13 prime bases
+        // (Sorenson and Webster), larger n take `rounds` bases, 2 and then pseudorandom ones
+        template <typename T, class Container, class Policy>
+        bool is_probable_prime(const natural<T, Container, Policy>& n, std::size_t rounds = 25) {
+            using natural_type = natural<T, Container, Policy>;
+            using test_type = primality<natural_type>;
+            const typename test_type::screening screening = test_type::screen(n);
+            if (screening != test_type::screening::unknown) return screening == test_type::screening::prime;
+            const test_type test(n);
+            const std::size_t bits = n.bit_width();
+            natural_type bound;
+            bound = 179817u;
+            bound <<= 64;
+            bound |= 5885577656943027709u;
+            if (bits <= 64 || (bits <= 82 && n < bound)) {
+                for (std::size_t i = 0; i < (bits <= 64 ? 12 : 13); ++i)
+                    if (!test.miller_rabin(i == 0 ? natural_type(2) : natural_type(kernel::small_primes.primes[i - 1])))
+                        return false;
+                return true;
+            }
+            if (!test.miller_rabin(natural_type(2))) return false;
+            // bases in [3, n - 2]
+            std::mt19937_64 urbg(n[0]);
+            // uniform_int_distribution takes no character types
+            std::uniform_int_distribution<std::conditional_t<(sizeof(T) < sizeof(unsigned short)), unsigned short, T>> distribution;
+            natural_type range(n);
+            range -= 4;
+            for (std::size_t i = 1; i < rounds; ++i) {
+                natural_type base = natural_type::random(bits, urbg, distribution);
+                base %= range;
+                base += 3;
+                if (!test.miller_rabin(base)) return false;
+            }
+            return true;
+        }
+        // Baillie-PSW, a strong probable prime to base 2 that is also a strong Lucas probable prime
+        // no composite passing it is known, none exists below 2^64
+        template <typename T, class Container, class Policy>
+        bool is_baillie_psw_prime(const natural<T, Container, Policy>& n) {
+            using test_type = primality<natural<T, Container, Policy>>;
+            const typename test_type::screening screening = test_type::screen(n);
+            if (screening != test_type::screening::unknown) return screening == test_type::screening::prime;
+            const test_type test(n);
+            return test.miller_rabin(natural<T, Container, Policy>(2)) && test.lucas();
+        }
+        // smallest prime above n, infinity when it does not fit
+        // odd candidates are sieved in windows by the whole prime table, survivors take the Baillie-PSW test
+        template <typename T, class Container, class Policy>
+        natural<T, Container, Policy> next_prime(const natural<T, Container, Policy>& n) {
+            using natural_type = natural<T, Container, Policy>;
+            using test_type = primality<natural_type>;
+            constexpr std::size_t width = kernel::limb_traits<T>::width;
+            if (n.is_NaN()) return n;
+            if (n.is_inf()) return natural_type::infinity();
+            if (n < 2) return natural_type(2);
+            const unsigned short* primes = kernel::small_primes.primes;
+            const std::size_t count = kernel::usable_primes<T>(kernel::small_primes.size);
+            if (n < primes[count - 1]) {
+                std::size_t i = 0;
+                while (n >= primes[i]) ++i;
+                return natural_type(primes[i]);
+            }
+            natural_type candidate(n);
+            candidate += n[0] % 2 ? 2 : 1;
+            // the expected gap is ln n, about 0.7 bits
+            const std::size_t window = 2 * n.bit_width() + 64;
+            std::vector<unsigned char> composite(window);
+            std::vector<unsigned short> residues(count);
+            std::vector<T> limbs;
+            while (!candidate.is_inf()) {
+                limbs.resize((candidate.bit_width() + width - 1) / width);
+                for (std::size_t i = 0; i < limbs.size(); ++i) limbs[i] = candidate[i];
+                kernel::small_prime_residues(residues.data(), limbs.data(), limbs.size(), count);
+                std::fill(composite.begin(), composite.end(), 0);
+                for (std::size_t i = 0; i < count; ++i) {
+                    // candidate + 2j = 0 mod p for j = -residue / 2 mod p
+                    const std::size_t p = primes[i];
+                    for (std::size_t j = (p - residues[i]) % p * ((p + 1) / 2) % p; j < window; j += p)
+                        composite[j] = 1;
+                }
+                for (std::size_t j = 0; j < window; ++j) {
+                    if (composite[j]) continue;
+                    natural_type x(candidate);
+                    x += 2 * j;
+                    if (x.is_inf()) return x;
+                    const test_type test(x);
+                    if (test.miller_rabin(natural_type(2)) && test.lucas()) return x;
+                }
+                candidate += 2 * window;
+            }
+            return candidate;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef HWSHQTB__BIG_NUMBER__RADIX_HPP
+#define HWSHQTB__BIG_NUMBER__RADIX_HPP
+
+#include "divide.hpp"
+#include "arena.hpp"
+#include <vector>
+
+namespace hwshqtb {
+    namespace big_number {
+        namespace kernel {
+            // limbs at or below which conversion runs one limb-sized chunk of digits at a time
+            constexpr std::size_t radix_basecase_limbs = 16;
+
+            // largest power of `base` that fits in one limb
+            template <typename T>
+            struct radix_chunk {
+                std::size_t digits;
+                T power;
+
+                HWSHQTB_CONSTEXPR14 explicit radix_chunk(unsigned base)noexcept:
+                    digits(0), power(1) {
+                    while (power <= (T)(~(T)0) / base) {
+                        power = (T)(power * base);
+                        ++digits;
+                    }
+                }
+            };
+
+            // log2(base) for power of two bases, 0 otherwise
+            constexpr std::size_t radix_shift(unsigned base)noexcept {
+                return (base & (base - 1)) ? 0 : base <= 1 ? 0 : 1 + radix_shift(base >> 1);
+            }
+            // upper bound of the digits of an n-limb number in `base`
+            template <typename T>
+            constexpr std::size_t digits_bound(std::size_t n, unsigned base)noexcept {
+                return n * limb_traits<T>::width / (radix_shift(base) ? radix_shift(base) : base >= 16 ? 4 : base >= 8 ? 3 : base >= 4 ? 2 : 1) + 1;
+            }
+            // upper bound of the limbs of a number of `count` digits in `base`
+            template <typename T>
+            constexpr std::size_t limbs_bound(std::size_t count, unsigned base)noexcept {
+                return count * (base > 32 ? 6 : base > 16 ? 5 : base > 8 ? 4 : base > 4 ? 3 : base > 2 ? 2 : 1) / limb_traits<T>::width + 1;
+            }
+
+            // the next entry of a power table, power^2 without leading zero limbs
+            template <class Policy, typename T>
+            std::vector<T> square_power(const std::vector<T>& power) {
+                std::vector<T> square(2 * power.size());
+                scratch_buffer<T> scratch(mul_scratch_size(power.size(), power.size()));
+                sqr<Policy>(square.data(), power.data(), power.size(), scratch.data());
+                square.resize(normalized_length(square.data(), square.size()));
+                return square;
+            }
+            // out = digits[0, count) without leading zeros, at least one digit is kept
+            inline std::size_t strip_digits(unsigned char* out, const unsigned char* digits, std::size_t count)noexcept {
+                std::size_t first = 0;
+                while (first + 1 < count && digits[first] == 0) ++first;
+                for (std::size_t i = first; i < count; ++i)
+                    out[i - first] = digits[i];
+                return count - first;
+            }
+            // writes exactly `count` digits of x < base^count, most significant first, x is destroyed
+            template <typename T>
+            void to_digits_basecase(unsigned char* out, std::size_t count, T* x, std::size_t n, unsigned base) {
+                const radix_chunk<T> chunk(base);
+                n = normalized_length(x, n);
+                while (count > 0) {
+                    T remainder = divrem_1(x, x, n, chunk.power);
+                    n = normalized_length(x, n);
+                    for (std::size_t i = 0; i < chunk.digits && count > 0; ++i, remainder /= base)
+                        out[--count] = (unsigned char)(remainder % base);
+                }
+            }
+            // writes exactly chunk digits * 2^level digits of x < powers[0]^(2^level), x is destroyed
+            // splits by powers[level - 1] = powers[0]^(2^(level - 1)), both halves are converted recursively
+            template <class Policy, typename T>
+            void to_digits_recursive(unsigned char* out, T* x, std::size_t n, const std::vector<std::vector<T>>& powers, std::size_t level, std::size_t chunk_digits, unsigned base) {
+                n = normalized_length(x, n);
+                const std::size_t count = chunk_digits << level;
+                if (level == 0 || n <= radix_basecase_limbs) {
+                    to_digits_basecase(out, count, x, n, base);
+                    return;
+                }
+                const std::vector<T>& power = powers[level - 1];
+                const std::size_t np = power.size(), half = count / 2;
+                if (n < np) {
+                    for (std::size_t i = 0; i < half; ++i) out[i] = 0;
+                    to_digits_recursive<Policy>(out + half, x, n, powers, level - 1, chunk_digits, base);
+                    return;
+                }
+                scratch_buffer<T> quotient(n - np + 1);
+                if (np == 1) x[0] = divrem_1(quotient.data(), x, n, power[0]);
+                else {
+                    scratch_buffer<T> scratch(div_scratch_size(n, np));
+                    div<Policy>(quotient.data(), x, n, power.data(), np, scratch.data());
+                }
+                // the halves are independent, a parallel Policy converts the high one as a task
+                if (is_parallel<Policy>(np)) {
+                    task_group group;
+                    group.run([&] {
+                        to_digits_recursive<Policy>(out, quotient.data(), quotient.size(), powers, level - 1, chunk_digits, base);
+                    });
+                    to_digits_recursive<Policy>(out + half, x, np, powers, level - 1, chunk_digits, base);
+                    group.wait();
+                    return;
+                }
+                to_digits_recursive<Policy>(out, quotient.data(), quotient.size(), powers, level - 1, chunk_digits, base);
+                to_digits_recursive<Policy>(out + half, x, np, powers, level - 1, chunk_digits, base);
+            }
+            // digits of x[0, n) in `base` (2 to 36), most significant first without leading zeros
+            // out must hold digits_bound<T>(n, base) digits, returns the number written
+            // large numbers are split by cached powers base^(k 2^i) with the divide and conquer division
+            template <class Policy, typename T>
+            std::size_t to_digits(unsigned char* out, const T* x, std::size_t n, unsigned base) {
+                constexpr std::size_t width = limb_traits<T>::width;
+                n = normalized_length(x, n);
+                if (n == 1 && x[0] == 0) {
+                    out[0] = 0;
+                    return 1;
+                }
+                if (const std::size_t shift = radix_shift(base)) {
+                    const std::size_t bits = n * width - count_leading_zeros(x[n - 1]);
+                    const std::size_t count = (bits + shift - 1) / shift;
+                    for (std::size_t i = 0; i < count; ++i) {
+                        const std::size_t position = i * shift, index = position / width, offset = position % width;
+                        T digit = x[index] >> offset;
+                        if (offset + shift > width && index + 1 < n)
+                            digit |= x[index + 1] << (width - offset);
+                        out[count - 1 - i] = (unsigned char)(digit & (T)(base - 1));
+                    }
+                    return count;
+                }
+
+                const radix_chunk<T> chunk(base);
+                if (n <= radix_basecase_limbs) {
+                    scratch_buffer<T> copy(n);
+                    std::copy_n(x, n, copy.data());
+                    scratch_buffer<unsigned char> digits(digits_bound<T>(n, base));
+                    to_digits_basecase(digits.data(), digits.size(), copy.data(), n, base);
+                    return strip_digits(out, digits.data(), digits.size());
+                }
+                // stop once x < powers.back()^2 = chunk.power^(2^powers.size())
+                std::vector<std::vector<T>> powers(1, std::vector<T>(1, chunk.power));
+                while (2 * powers.back().size() - 2 < n)
+                    powers.push_back(square_power<Policy>(powers.back()));
+                scratch_buffer<T> copy(n);
+                std::copy_n(x, n, copy.data());
+                scratch_buffer<unsigned char> digits(chunk.digits << powers.size());
+                to_digits_recursive<Policy>(digits.data(), copy.data(), n, powers, powers.size(), chunk.digits, base);
+                return strip_digits(out, digits.data(), digits.size());
+            }
+
+            // value of digits[0, count), most significant first, r must hold limbs_bound<T>(count, base) limbs
+            template <typename T>
+            std::size_t from_digits_basecase(T* r, const unsigned char* digits, std::size_t count, unsigned base) {
+                const radix_chunk<T> chunk(base);
+                std::size_t n = 1;
+                r[0] = 0;
+                // the first chunk absorbs count % chunk.digits so that the rest are full
+                std::size_t length = count % chunk.digits ? count % chunk.digits : chunk.digits;
+                for (std::size_t i = 0; i < count; i += length, length = chunk.digits) {
+                    T value = 0, scale = 1;
+                    for (std::size_t j = 0; j < length && i + j < count; ++j) {
+                        value = (T)(value * base + digits[i + j]);
+                        scale = (T)(scale * base);
+                    }
+                    T carry = mul_1(r, r, n, scale);
+                    carry += add_1(r, r, n, value);
+                    if (carry) r[n++] = carry;
+                }
+                return normalized_length(r, n);
+            }
+            // r = value of at most chunk digits * 2^level digits, high part times powers[level - 1] plus low part
+            // r must hold limbs_bound<T>(count, base) + 1 limbs, returns the normalized length
+            template <class Policy, typename T>
+            std::size_t from_digits_recursive(T* r, const unsigned char* digits, std::size_t count, const std::vector<std::vector<T>>& powers, std::size_t level, std::size_t chunk_digits, unsigned base) {
+                const std::size_t half = chunk_digits << (level ? level - 1 : 0);
+                if (level == 0 || count <= radix_basecase_limbs * chunk_digits)
+                    return from_digits_basecase(r, digits, count, base);
+                if (count <= half) return from_digits_recursive<Policy>(r, digits, count, powers, level - 1, chunk_digits, base);
+                scratch_buffer<T> high(limbs_bound<T>(count - half, base) + 1), low(limbs_bound<T>(half, base) + 1);
+                const std::vector<T>& power = powers[level - 1];
+                std::size_t nh = 0, nl = 0;
+                if (is_parallel<Policy>(power.size())) {
+                    task_group group;
+                    group.run([&] {
+                        nh = from_digits_recursive<Policy>(high.data(), digits, count - half, powers, level - 1, chunk_digits, base);
+                    });
+                    nl = from_digits_recursive<Policy>(low.data(), digits + count - half, half, powers, level - 1, chunk_digits, base);
+                    group.wait();
+                }
+                else {
+                    nh = from_digits_recursive<Policy>(high.data(), digits, count - half, powers, level - 1, chunk_digits, base);
+                    nl = from_digits_recursive<Policy>(low.data(), digits + count - half, half, powers, level - 1, chunk_digits, base);
+                }
+                scratch_buffer<T> result(nh + power.size() + 1), scratch(mul_scratch_size(nh, power.size()));
+                mul<Policy>(result.data(), high.data(), nh, power.data(), power.size(), scratch.data());
+                result[nh + power.size()] = 0;
+                add_into(result.data(), result.size(), low.data(), nl);
+                const std::size_t n = normalized_length(result.data(), result.size());
+                std::copy_n(result.data(), n, r);
+                return n;
+            }
+            // r = value of digits[0, count) in `base` (2 to 36), most significant first
+            // r must hold limbs_bound<T>(count, base) limbs, returns the normalized length
+            // long inputs are split in halves and recombined with the fast multiplication
+            template <class Policy, typename T>
+            std::size_t from_digits(T* r, const unsigned char* digits, std::size_t count, unsigned base) {
+                constexpr std::size_t width = limb_traits<T>::width;
+                if (count == 0) {
+                    r[0] = 0;
+                    return 1;
+                }
+                if (const std::size_t shift = radix_shift(base)) {
+                    const std::size_t n = (count * shift + width - 1) / width;
+                    for (std::size_t i = 0; i < n; ++i) r[i] = 0;
+                    for (std::size_t i = 0; i < count; ++i) {
+                        const std::size_t position = i * shift, index = position / width, offset = position % width;
+                        const T digit = digits[count - 1 - i];
+                        r[index] |= (T)(digit << offset);
+                        if (offset + shift > width)
+                            r[index + 1] |= (T)(digit >> (width - offset));
+                    }
+                    return normalized_length(r, n);
+                }
+
+                const radix_chunk<T> chunk(base);
+                if (count <= radix_basecase_limbs * chunk.digits)
+                    return from_digits_basecase(r, digits, count, base);
+                std::vector<std::vector<T>> powers(1, std::vector<T>(1, chunk.power));
+                while ((chunk.digits << powers.size()) < count)
+                    powers.push_back(square_power<Policy>(powers.back()));
+                // r holds one limb less than the recursion asks for
+                scratch_buffer<T> result(limbs_bound<T>(count, base) + 1);
+                const std::size_t n = from_digits_recursive<Policy>(result.data(), digits, count, powers, powers.size(), chunk.digits, base);
+                std::copy_n(result.data(), n, r);
+                return n;
+            }
+        }
+    }
+}
+
+#endif
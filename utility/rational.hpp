@@ -0,0 +1,392 @@
+#ifndef HWSHQTB__BIG_NUMBER__RATIONAL_HPP
+#define HWSHQTB__BIG_NUMBER__RATIONAL_HPP
+
+#include "integer.hpp"
+#include "gcd.hpp"
+
+namespace hwshqtb {
+    namespace big_number {
+        // signed numerator over a positive denominator, kept in lowest terms lazily
+        // operations leave common factors in place and reduce only once a part grows past a limit,
+        // the limit doubles with the reduced size so that the gcd cost stays amortized
+        // NaN and infinities live in the numerator over 1, a zero denominator or a denominator overflow gives NaN
+        template <class Natural = natural<>>
+        class rational {
+        public:
+            using natural_type = Natural;
+            using integer_type = integer<Natural>;
+            using value_type = typename natural_type::value_type;
+            using size_type = typename natural_type::size_type;
+
+        private:
+            static constexpr size_type type_width = kernel::limb_traits<value_type>::width;
+            // bits of fixed storage, 0 when the storage grows
+            static constexpr size_type capacity_bits = static_capacity<typename natural_type::container_type>::value * type_width;
+            // growth allowed past a small reduced size before the next reduction
+            static constexpr size_type reduce_slack = 256;
+
+        public:
+            rational():
+                _numerator(), _denominator(1), _reduced(true), _limit(0) {
+                settle();
+            }
+            template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+            rational(Integer v):
+                _numerator(v), _denominator(1), _reduced(true), _limit(0) {
+                settle();
+            }
+            rational(const integer_type& v):
+                _numerator(v), _denominator(1), _reduced(true), _limit(0) {
+                settle();
+            }
+            rational(const natural_type& v):
+                _numerator(v), _denominator(1), _reduced(true), _limit(0) {
+                settle();
+            }
+            // numerator / denominator, not reduced until the limit is crossed
+            rational(const integer_type& numerator, const integer_type& denominator):
+                _numerator(numerator), _denominator(denominator.magnitude()), _reduced(false), _limit(0) {
+                if (denominator.is_NaN() || numerator.is_NaN() || denominator.is_zero()) to_NaN();
+                else if (denominator.is_infinity()) {
+                    // x / inf is a signed zero, inf / inf is NaN
+                    _numerator /= denominator;
+                    _denominator = 1;
+                    _reduced = true;
+                }
+                else if (denominator.is_negative()) _numerator.negate();
+                settle();
+            }
+            rational(const rational&) = default;
+            rational(rational&&) = default;
+            ~rational() = default;
+
+            rational& operator=(const rational&) = default;
+            rational& operator=(rational&&) = default;
+
+            bool is_NaN()const noexcept {
+                return _numerator.is_NaN();
+            }
+            bool is_zero()const noexcept {
+                return _numerator.is_zero();
+            }
+            bool is_infinity()const noexcept {
+                return _numerator.is_infinity();
+            }
+            // sign bit, also set for negative zero
+            bool is_negative()const noexcept {
+                return _numerator.is_negative();
+            }
+            // true once no common factor is left, zero is then 0 / 1
+            bool is_normalized()const noexcept {
+                return _reduced;
+            }
+            // the parts as stored, lowest terms only after normalize()
+            const integer_type& numerator()const noexcept {
+                return _numerator;
+            }
+            const natural_type& denominator()const noexcept {
+                return _denominator;
+            }
+
+            // divides out the gcd of the parts
+            rational& normalize() {
+                if (!_reduced) {
+                    const natural_type g = gcd(_numerator.magnitude(), _denominator);
+                    if (g != 1) {
+                        _numerator = integer_type(_numerator.magnitude() / g, _numerator.is_negative());
+                        _denominator /= g;
+                    }
+                    _reduced = true;
+                }
+                // a reduced part of s bits is reduced again at max(2 s, s + slack) bits
+                const size_type bits = size();
+                _limit = std::max(2 * bits, bits + reduce_slack);
+                // fixed storage keeps the cross products of two parts within the capacity
+                if (capacity_bits) _limit = std::min(_limit, capacity_bits / 2 - 1);
+                return *this;
+            }
+
+            rational& negate()noexcept {
+                _numerator.negate();
+                return *this;
+            }
+
+            // equal denominators add the numerators, an integer operand keeps the other one reduced
+            rational& operator+=(const rational& other) {
+                return add(other, false);
+            }
+            rational& operator-=(const rational& other) {
+                return add(other, true);
+            }
+            rational& operator*=(const rational& other) {
+                if (is_NaN() || other.is_NaN()) return to_NaN();
+                if (is_infinity() || other.is_infinity()) {
+                    // inf * 0 is NaN, otherwise the numerators carry the sign
+                    _numerator *= other._numerator;
+                    return to_integer();
+                }
+                _numerator *= other._numerator;
+                _denominator *= other._denominator;
+                _reduced = false;
+                _limit = std::max(_limit, other._limit);
+                return settle();
+            }
+            // division by zero is NaN like natural, x / inf is a signed zero
+            rational& operator/=(const rational& other) {
+                if (is_NaN() || other.is_NaN() || other.is_zero()) return to_NaN();
+                if (is_infinity() || other.is_infinity()) {
+                    _numerator /= other._numerator;
+                    return to_integer();
+                }
+                const bool negative = _numerator.is_negative() != other._numerator.is_negative();
+                if (_denominator == other._denominator) {
+                    // (a / b) / (c / b) = a / c
+                    _numerator = integer_type(_numerator.magnitude(), negative);
+                    _denominator = other._numerator.magnitude();
+                }
+                else {
+                    const natural_type divisor = other._numerator.magnitude();
+                    _numerator = integer_type(_numerator.magnitude() * other._denominator, negative);
+                    _denominator *= divisor;
+                }
+                _reduced = false;
+                _limit = std::max(_limit, other._limit);
+                return settle();
+            }
+
+            friend rational operator+(const rational& x, const rational& y) {
+                rational result = x;
+                return result += y;
+            }
+            friend rational operator+(rational&& x, const rational& y) {
+                return std::move(x += y);
+            }
+            friend rational operator-(const rational& x, const rational& y) {
+                rational result = x;
+                return result -= y;
+            }
+            friend rational operator-(rational&& x, const rational& y) {
+                return std::move(x -= y);
+            }
+            friend rational operator*(const rational& x, const rational& y) {
+                rational result = x;
+                return result *= y;
+            }
+            friend rational operator*(rational&& x, const rational& y) {
+                return std::move(x *= y);
+            }
+            friend rational operator/(const rational& x, const rational& y) {
+                rational result = x;
+                return result /= y;
+            }
+            friend rational operator/(rational&& x, const rational& y) {
+                return std::move(x /= y);
+            }
+            friend rational operator+(const rational& x) {
+                return x;
+            }
+            friend rational operator-(const rational& x) {
+                rational result = x;
+                return result.negate();
+            }
+
+            // NaN is unordered, +0 == -0
+            // reduced operands compare part by part, equal denominators by the numerators, the rest cross-multiplied
+            friend bool operator==(const rational& x, const rational& y) {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                if (x._reduced && y._reduced)
+                    return x._numerator == y._numerator && x._denominator == y._denominator;
+                return x.compare(y) == 0;
+            }
+            friend bool operator!=(const rational& x, const rational& y) {
+                return !(x == y);
+            }
+            friend bool operator<(const rational& x, const rational& y) {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) < 0;
+            }
+            friend bool operator<=(const rational& x, const rational& y) {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) <= 0;
+            }
+            friend bool operator>(const rational& x, const rational& y) {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) > 0;
+            }
+            friend bool operator>=(const rational& x, const rational& y) {
+                if (x.is_NaN() || y.is_NaN()) return false;
+                return x.compare(y) >= 0;
+            }
+
+            // lowest terms as integer writes it, "/denominator" follows unless the denominator is 1
+            friend std::to_chars_result to_chars(char* first, char* last, const rational& x, int base = 10) {
+                if (!x._reduced) {
+                    rational reduced = x;
+                    return to_chars(first, last, reduced.normalize(), base);
+                }
+                std::to_chars_result result = to_chars(first, last, x._numerator, base);
+                if (result.ec != std::errc() || x._denominator == 1) return result;
+                if (result.ptr == last) return {last, std::errc::value_too_large};
+                *result.ptr++ = '/';
+                return to_chars(result.ptr, last, x._denominator, base);
+            }
+            // what integer accepts, optionally followed by '/' and what natural accepts, x is untouched on failure
+            friend std::from_chars_result from_chars(const char* first, const char* last, rational& x, int base = 10) {
+                integer_type numerator;
+                std::from_chars_result result = from_chars(first, last, numerator, base);
+                if (result.ec != std::errc()) return result;
+                natural_type denominator(1);
+                if (result.ptr != last && *result.ptr == '/') {
+                    const std::from_chars_result tail = from_chars(result.ptr + 1, last, denominator, base);
+                    if (tail.ec != std::errc()) return {first, tail.ec};
+                    result.ptr = tail.ptr;
+                }
+                x = rational(numerator, integer_type(denominator));
+                return result;
+            }
+            template <class CharT, class Traits>
+            friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const rational& x) {
+                if (!x._reduced) {
+                    rational reduced = x;
+                    return os << reduced.normalize();
+                }
+                os << x._numerator;
+                if (x._denominator != 1) os << os.widen('/') << x._denominator;
+                return os;
+            }
+            template <class CharT, class Traits>
+            friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, rational& x) {
+                integer_type numerator;
+                if (!(is >> numerator)) return is;
+                natural_type denominator(1);
+                if (Traits::eq_int_type(is.peek(), Traits::to_int_type(is.widen('/')))) {
+                    is.get();
+                    // the denominator follows the slash directly
+                    const std::ios_base::fmtflags flags = is.flags();
+                    is.unsetf(std::ios_base::skipws);
+                    is >> denominator;
+                    is.flags(flags);
+                    if (!is) return is;
+                }
+                x = rational(numerator, integer_type(denominator));
+                return is;
+            }
+
+        private:
+            rational& to_NaN()noexcept {
+                _numerator.to_quiet_NaN();
+                _denominator = 1;
+                _reduced = true;
+                return *this;
+            }
+            // the numerator alone holds the value
+            rational& to_integer()noexcept {
+                _denominator = 1;
+                _reduced = true;
+                return *this;
+            }
+            // bits of the larger part
+            size_type size()const noexcept {
+                return std::max(_numerator.magnitude().bit_width(), _denominator.bit_width());
+            }
+            // settles overflows and reduces once the parts grow past the limit
+            rational& settle() {
+                if (_numerator.is_NaN() || _denominator.is_NaN() || _denominator.is_inf()) return to_NaN();
+                if (_numerator.is_infinity()) return to_integer();
+                if (_numerator.is_zero()) _denominator = 1;
+                if (_denominator == 1) _reduced = true;
+                if (size() > _limit) normalize();
+                return *this;
+            }
+            // *this += (-1)^subtract other
+            rational& add(const rational& other, bool subtract) {
+                if (is_NaN() || other.is_NaN()) return to_NaN();
+                integer_type addend = other._numerator;
+                if (subtract) addend.negate();
+                if (is_infinity() || other.is_infinity()) {
+                    // inf - inf is NaN, a finite operand counts as zero
+                    if (!is_infinity()) _numerator = integer_type::zero();
+                    if (!other.is_infinity()) addend = integer_type::zero();
+                    _numerator += addend;
+                    return to_integer();
+                }
+                if (_denominator == other._denominator) {
+                    // a / b + c / b = (a + c) / b
+                    _numerator += addend;
+                    _reduced = _denominator == 1;
+                }
+                else if (other._denominator == 1) {
+                    // gcd(a + c b, b) = gcd(a, b)
+                    addend *= integer_type(_denominator);
+                    _numerator += addend;
+                }
+                else if (_denominator == 1) {
+                    _numerator *= integer_type(other._denominator);
+                    _numerator += addend;
+                    _denominator = other._denominator;
+                    _reduced = other._reduced;
+                }
+                else {
+                    // a / b + c / d = (a d + c b) / (b d)
+                    _numerator *= integer_type(other._denominator);
+                    addend *= integer_type(_denominator);
+                    _numerator += addend;
+                    _denominator *= other._denominator;
+                    _reduced = false;
+                }
+                _limit = std::max(_limit, other._limit);
+                return settle();
+            }
+            // -1, 0, 1 for *this <=> other, neither NaN
+            int compare(const rational& other)const {
+                if (is_infinity() || other.is_infinity() || (_denominator == other._denominator)) {
+                    // the numerators order infinities against anything, and equal denominators exactly
+                    if (_numerator == other._numerator) return 0;
+                    return _numerator < other._numerator ? -1 : 1;
+                }
+                const int sign = is_zero() ? 0 : is_negative() ? -1 : 1;
+                const int other_sign = other.is_zero() ? 0 : other.is_negative() ? -1 : 1;
+                if (sign != other_sign) return sign < other_sign ? -1 : 1;
+                if (sign == 0) return 0;
+                const int order = compare_magnitude(_numerator.magnitude(), _denominator, other._numerator.magnitude(), other._denominator);
+                return sign < 0 ? -order : order;
+            }
+            // -1, 0, 1 for a / b <=> c / d, all finite and b, d nonzero
+            static int compare_magnitude(const natural_type& a, const natural_type& b, const natural_type& c, const natural_type& d) {
+                const natural_type left = a * d, right = c * b;
+                if (!left.is_inf() && !right.is_inf()) return left == right ? 0 : left < right ? -1 : 1;
+                // the cross products overflow the storage, compare the continued fractions instead
+                return compare_fractions(a, b, c, d);
+            }
+            static int compare_fractions(natural_type a, natural_type b, natural_type c, natural_type d) {
+                for (int sign = 1;; sign = -sign) {
+                    const natural_type p = a.div(b), q = c.div(d);
+                    if (p != q) return p < q ? -sign : sign;
+                    // a / b and c / d now hold the fractional parts
+                    if (a.is_zero() || c.is_zero()) {
+                        if (a.is_zero() && c.is_zero()) return 0;
+                        return a.is_zero() ? -sign : sign;
+                    }
+                    // a / b < c / d exactly when b / a > d / c
+                    std::swap(a, b);
+                    std::swap(c, d);
+                }
+            }
+
+            integer_type _numerator;
+            natural_type _denominator;
+            bool _reduced;
+            size_type _limit;
+
+        };
+    }
+}
+
+namespace std {
+    template <class Natural>
+    hwshqtb::big_number::rational<Natural> abs(const hwshqtb::big_number::rational<Natural>& x) {
+        return x.is_negative() ? -x : x;
+    }
+}
+
+#endif
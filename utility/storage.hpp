@@ -0,0 +1,213 @@
+#ifndef HWSHQTB__BIG_NUMBER__STORAGE_HPP
+#define HWSHQTB__BIG_NUMBER__STORAGE_HPP
+
+#include "base.hpp"
+#include <memory>
+#include <algorithm>
+#include <tuple>
+
+namespace hwshqtb {
+    namespace big_number {
+        // containers with `resize(size_type)` let natural grow on carry-out instead of saturating to infinity
+        template <class Container, typename = void>
+        struct is_growable_storage: std::false_type {};
+        template <class Container>
+        struct is_growable_storage<Container, decltype(std::declval<Container&>().resize(std::declval<typename Container::size_type>()), void())>: std::true_type {};
+        // limbs of a fixed-size container known at compile time (std::array), 0 otherwise
+        template <class Container, typename = void>
+        struct static_capacity: std::integral_constant<std::size_t, 0> {};
+        template <class Container>
+        struct static_capacity<Container, std::void_t<decltype(std::tuple_size<Container>::value)>>: std::integral_constant<std::size_t, std::tuple_size<Container>::value> {};
+
+        // limb storage with small buffer optimization, the first `Inline` limbs live inside the object
+        // and larger sizes spill to the heap, resize() keeps the existing limbs and zero-fills the new ones
+        template <typename T, std::size_t Inline = 2, class Allocator = std::allocator<T>>
+        class small_storage: private Allocator {
+            static_assert(std::is_trivial<T>::value, "T must be trivial type");
+            static_assert(Inline >= 1, "");
+
+        public:
+            using value_type = T;
+            using allocator_type = Allocator;
+            using size_type = std::size_t;
+            using reference = value_type&;
+            using const_reference = const value_type&;
+            using pointer = value_type*;
+            using const_pointer = const value_type*;
+
+        private:
+            using allocator_traits = std::allocator_traits<allocator_type>;
+
+        public:
+            small_storage()noexcept(noexcept(allocator_type())):
+                allocator_type(), _size(Inline) {
+                std::fill_n(_inline, Inline, value_type());
+            }
+            explicit small_storage(const allocator_type& allocator)noexcept:
+                allocator_type(allocator), _size(Inline) {
+                std::fill_n(_inline, Inline, value_type());
+            }
+            explicit small_storage(size_type count, const allocator_type& allocator = allocator_type()):
+                small_storage(allocator) {
+                resize(count);
+            }
+            small_storage(const small_storage& other):
+                small_storage(allocator_traits::select_on_container_copy_construction(other.get_allocator())) {
+                resize(other._size);
+                std::memcpy(data(), other.data(), _size * sizeof(value_type));
+            }
+            small_storage(small_storage&& other)noexcept:
+                allocator_type(std::move(other.get_allocator())), _size(other._size) {
+                if (other.on_heap()) {
+                    _heap = other._heap;
+                    other._size = Inline;
+                    std::fill_n(other._inline, Inline, value_type());
+                }
+                else std::memcpy(_inline, other._inline, Inline * sizeof(value_type));
+            }
+            ~small_storage() {
+                release();
+            }
+
+            // assignment takes over the size of `other` exactly, natural encodes infinity relative to size()
+            small_storage& operator=(const small_storage& other) {
+                if (this == &other) return *this;
+                if (_size != other._size) {
+                    release();
+                    resize(other._size);
+                }
+                std::memcpy(data(), other.data(), _size * sizeof(value_type));
+                return *this;
+            }
+            small_storage& operator=(small_storage&& other)noexcept {
+                if (this == &other) return *this;
+                release();
+                _size = other._size;
+                if (other.on_heap()) {
+                    _heap = other._heap;
+                    other._size = Inline;
+                    std::fill_n(other._inline, Inline, value_type());
+                }
+                else std::memcpy(_inline, other._inline, Inline * sizeof(value_type));
+                return *this;
+            }
+
+            allocator_type get_allocator()const noexcept {
+                return *this;
+            }
+
+            pointer data()noexcept {
+                return on_heap() ? _heap : _inline;
+            }
+            const_pointer data()const noexcept {
+                return on_heap() ? _heap : _inline;
+            }
+            reference operator[](size_type pos)noexcept {
+                return data()[pos];
+            }
+            const_reference operator[](size_type pos)const noexcept {
+                return data()[pos];
+            }
+
+            size_type size()const noexcept {
+                return _size;
+            }
+            size_type max_size()const noexcept {
+                return allocator_traits::max_size(get_allocator_ref());
+            }
+            // only ever grows, a smaller count keeps the current buffer
+            void resize(size_type count) {
+                if (count <= _size) return;
+                pointer buffer = allocator_traits::allocate(get_allocator_ref(), count);
+                std::memcpy(buffer, data(), _size * sizeof(value_type));
+                std::fill(buffer + _size, buffer + count, value_type());
+                release();
+                _heap = buffer;
+                _size = count;
+            }
+
+        private:
+            bool on_heap()const noexcept {
+                return _size > Inline;
+            }
+            void release()noexcept {
+                if (on_heap())
+                    allocator_traits::deallocate(get_allocator_ref(), _heap, _size);
+                _size = Inline;
+                std::fill_n(_inline, Inline, value_type());
+            }
+            allocator_type& get_allocator_ref()noexcept {
+                return *this;
+            }
+            const allocator_type& get_allocator_ref()const noexcept {
+                return *this;
+            }
+
+            union {
+                value_type _inline[Inline];
+                pointer _heap;
+            };
+            size_type _size;
+
+        };
+
+        // non-owning view of `size()` limbs, least significant first, over memory the caller keeps alive,
+        // e.g. a memory mapped file, natural reads it in place without copying into its own storage
+        // zero limbs on top are allowed and ignored, an empty view is zero
+        template <typename T>
+        class limb_view {
+            static_assert(std::is_integral<T>::value && !std::numeric_limits<T>::is_signed, "T must be unsigned integral type");
+
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using const_pointer = const value_type*;
+            using const_iterator = const value_type*;
+
+            constexpr limb_view()noexcept:
+                _data(nullptr), _size(0) {}
+            constexpr limb_view(const value_type* data, size_type size)noexcept:
+                _data(data), _size(size) {}
+            // any contiguous container of T, std::vector, std::array or small_storage
+            template <class Container, std::enable_if_t<std::is_same<std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<const Container&>().data())>>, value_type>::value, int> = 0>
+            constexpr limb_view(const Container& limbs)noexcept:
+                _data(limbs.data()), _size(limbs.size()) {}
+
+            constexpr const value_type* data()const noexcept {
+                return _data;
+            }
+            constexpr size_type size()const noexcept {
+                return _size;
+            }
+            constexpr bool empty()const noexcept {
+                return _size == 0;
+            }
+            constexpr value_type operator[](size_type index)const noexcept {
+                return _data[index];
+            }
+            constexpr const_iterator begin()const noexcept {
+                return _data;
+            }
+            constexpr const_iterator end()const noexcept {
+                return _data + _size;
+            }
+            // the limbs below `count`
+            constexpr limb_view first(size_type count)const noexcept {
+                return {_data, count};
+            }
+            // without the zero limbs on top
+            HWSHQTB_CONSTEXPR14 limb_view normalized()const noexcept {
+                size_type size = _size;
+                while (size != 0 && _data[size - 1] == 0) --size;
+                return {_data, size};
+            }
+
+        private:
+            const value_type* _data;
+            size_type _size;
+
+        };
+    }
+}
+
+#endif
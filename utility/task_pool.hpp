@@ -0,0 +1,187 @@
+#ifndef HWSHQTB__BIG_NUMBER__TASK_POOL_HPP
+#define HWSHQTB__BIG_NUMBER__TASK_POOL_HPP
+
+#include "base.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hwshqtb {
+    namespace big_number {
+        // work-stealing thread pool for the sub-products of huge multiplications
+        // every worker owns a deque, takes its newest task first and steals the oldest task of the others,
+        // threads outside the pool share one more deque, a thread waiting for a task_group runs tasks meanwhile
+        class task_pool {
+        public:
+            using task_type = std::function<void()>;
+            using size_type = std::size_t;
+
+            // `threads` counts the caller, which works while it waits, so threads - 1 workers are started
+            explicit task_pool(size_type threads = std::thread::hardware_concurrency()) {
+                const size_type workers = threads > 1 ? threads - 1 : 0;
+                for (size_type i = 0; i <= workers; ++i)
+                    _queues.push_back(std::make_unique<queue_type>());
+                for (size_type i = 0; i < workers; ++i)
+                    _workers.emplace_back([this, i] {
+                        work(i);
+                    });
+            }
+            task_pool(const task_pool&) = delete;
+            task_pool& operator=(const task_pool&) = delete;
+            ~task_pool() {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stop = true;
+                }
+                _wake.notify_all();
+                for (std::thread& worker : _workers) worker.join();
+            }
+
+            // threads that run tasks, the workers and one waiting caller
+            size_type concurrency()const noexcept {
+                return _workers.size() + 1;
+            }
+
+            void submit(task_type task) {
+                queue_type& queue = *_queues[own_queue()];
+                // counted before it is queued, so a thief never takes the count below zero
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    ++_pending;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    queue.tasks.push_back(std::move(task));
+                }
+                _wake.notify_one();
+            }
+            // runs one queued task on the calling thread, false when there is none
+            bool run_one() {
+                task_type task;
+                if (!take(own_queue(), task)) return false;
+                task();
+                return true;
+            }
+
+            // the pool shared by every parallel_policy, one thread per core
+            static task_pool& instance() {
+                static task_pool pool;
+                return pool;
+            }
+
+        private:
+            struct queue_type {
+                std::mutex mutex;
+                std::deque<task_type> tasks;
+            };
+
+            // the deque of a worker of this pool, the shared deque for any other thread
+            size_type own_queue()const noexcept {
+                return current_pool() == this ? current_index() : _workers.size();
+            }
+            // the newest task of `index`, otherwise the oldest task of another deque
+            bool take(size_type index, task_type& task) {
+                for (size_type k = 0; k < _queues.size(); ++k) {
+                    queue_type& queue = *_queues[(index + k) % _queues.size()];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (queue.tasks.empty()) continue;
+                    if (k == 0) {
+                        task = std::move(queue.tasks.back());
+                        queue.tasks.pop_back();
+                    }
+                    else {
+                        task = std::move(queue.tasks.front());
+                        queue.tasks.pop_front();
+                    }
+                    --_pending;
+                    return true;
+                }
+                return false;
+            }
+            void work(size_type index) {
+                current_pool() = this;
+                current_index() = index;
+                while (true) {
+                    if (run_one()) continue;
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _wake.wait(lock, [this] {
+                        return _stop || _pending != 0;
+                    });
+                    if (_stop) return;
+                }
+            }
+
+            static const task_pool*& current_pool()noexcept {
+                static thread_local const task_pool* pool = nullptr;
+                return pool;
+            }
+            static size_type& current_index()noexcept {
+                static thread_local size_type index = 0;
+                return index;
+            }
+
+            std::vector<std::unique_ptr<queue_type>> _queues;
+            std::vector<std::thread> _workers;
+            std::mutex _mutex;
+            std::condition_variable _wake;
+            std::atomic<size_type> _pending{0};
+            bool _stop = false;
+
+        };
+
+        // fork-join over a task_pool, wait() returns once every task run() so far has finished
+        // the waiting thread runs queued tasks itself, so groups nest without deadlock
+        class task_group {
+        public:
+            explicit task_group(task_pool& pool = task_pool::instance())noexcept:
+                _pool(pool) {}
+            task_group(const task_group&) = delete;
+            task_group& operator=(const task_group&) = delete;
+            ~task_group() {
+                wait();
+            }
+
+            template <class F>
+            void run(F f) {
+                ++_running;
+                _pool.submit([this, f]() mutable {
+                    f();
+                    --_running;
+                });
+            }
+            void wait() {
+                while (_running != 0)
+                    if (!_pool.run_one()) std::this_thread::yield();
+            }
+
+        private:
+            task_pool& _pool;
+            std::atomic<std::size_t> _running{0};
+
+        };
+
+        // f(begin, end) over chunks of [first, last) of at least `grain` indices, a few chunks per thread
+        template <class F>
+        void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F f) {
+            if (first >= last) return;
+            task_pool& pool = task_pool::instance();
+            const std::size_t chunk = std::max<std::size_t>({grain, 1, (last - first + 4 * pool.concurrency() - 1) / (4 * pool.concurrency())});
+            task_group group(pool);
+            std::size_t begin = first;
+            for (; last - begin > chunk; begin += chunk)
+                group.run([&f, begin, chunk] {
+                    f(begin, begin + chunk);
+                });
+            f(begin, last);
+            group.wait();
+        }
+    }
+}
+
+#endif